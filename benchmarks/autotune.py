@@ -0,0 +1,298 @@
+#!/usr/bin/env python3
+"""Successive halving over scheduler settings, the helper of autotune.sh.
+
+    benchmarks/autotune.py candidates [--space FILE] [-n N] [--seed S] > candidates.json
+    benchmarks/autotune.py workload --cpus C --node-cpus K [--jobs N | --trace SACCT] ...
+    benchmarks/autotune.py fragment candidates.json ID
+    benchmarks/autotune.py score --objective O --cpus C SACCT
+    benchmarks/autotune.py promote --objective O --keep K scores.txt RUNG
+    benchmarks/autotune.py report --objective O --cpus C OUT_DIR
+
+A candidate is one value for every parameter of the search space: options of
+SchedulerParameters and slurm.conf keys such as PriorityWeightAge.  The
+candidate "default" is the base slurm.conf; it runs in every rung without
+taking a place, so the winner is always compared with it.  The workload is a bash script of
+`sbatch` calls at fixed offsets, either synthetic (Poisson arrivals at
+--load times the cluster's capacity) or replayed from the sacct records of
+an earlier run, sped up by --speedup.  Rungs run a prefix of it.
+
+Objectives come from workload_stats.analyze: mean_wait and
+bounded_slowdown (lower is better) or utilization (higher is better).  The
+report gives a bootstrap confidence interval of the objective for the
+default and the winner, and the Mann-Whitney p-value of their job waits.
+"""
+
+import argparse
+import itertools
+import json
+import math
+import os
+import random
+import sys
+from collections import OrderedDict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from report import mann_whitney  # noqa: E402
+from stats import percentile, record  # noqa: E402
+from workload_stats import analyze, read_jobs  # noqa: E402
+
+DEFAULT = "default"
+
+# Values per parameter.  SchedulerParameters options map to a value, True
+# for a flag that is set or None for an option left out.
+SPACE = OrderedDict([
+    ("SchedulerParameters", OrderedDict([
+        ("default_queue_depth", [None, 20, 500]),
+        ("sched_interval", [None, 10, 30]),
+        ("sched_min_interval", [None, 100000, 1000000]),
+        ("bf_interval", [None, 5, 60]),
+        ("bf_resolution", [None, 10, 300]),
+        ("bf_window", [None, 60, 1440]),
+        ("bf_max_job_test", [None, 50, 1000]),
+        ("bf_continue", [None, True]),
+    ])),
+    ("PriorityType", ["priority/basic", "priority/multifactor"]),
+    ("PriorityWeightAge", [0, 1000, 10000]),
+    ("PriorityWeightJobSize", [0, 1000, 10000]),
+    ("PriorityFavorSmall", ["NO", "YES"]),
+    ("PriorityMaxAge", ["1-0", "0-1"]),
+])
+
+# Objective: (key of analyze()["all"], better)
+OBJECTIVES = OrderedDict([
+    ("mean_wait", ("wait_mean", "lower")),
+    ("bounded_slowdown", ("bounded_slowdown", "lower")),
+    ("utilization", ("utilization", "higher")),
+])
+
+BOOTSTRAP = 1000
+CONFIDENCE = 95
+
+
+def sample(space, rng):
+    params = OrderedDict()
+    for key, values in space.items():
+        if isinstance(values, dict):
+            params[key] = OrderedDict((option, rng.choice(v)) for option, v in values.items())
+        else:
+            params[key] = rng.choice(values)
+    return params
+
+
+def fragment(params):
+    """slurm.conf lines of a candidate's parameters."""
+    lines = []
+    for key, value in params.items():
+        if isinstance(value, dict):
+            options = [o if v is True else "%s=%s" % (o, v)
+                       for o, v in value.items() if v is not None and v is not False]
+            if options:
+                lines.append("%s=%s" % (key, ",".join(options)))
+        else:
+            lines.append("%s=%s" % (key, value))
+    return "\n".join(lines)
+
+
+def workload(args):
+    """Print the workload as a bash script for the controller."""
+    rng = random.Random(args.seed)
+    jobs = []
+    if args.trace:
+        records = sorted(read_jobs(args.trace), key=lambda j: j["submit"])
+        first = records[0]["submit"] if records else 0
+        for j in records:
+            runtime = max(1, int(round((j["end"] - j["start"]) / args.speedup)))
+            jobs.append(((j["submit"] - first) / args.speedup,
+                         min(max(1, j["cpus"]), args.node_cpus), runtime))
+    else:
+        # Mean runtime of the log-uniform distribution between 1 and max.
+        mean_runtime = (args.max_runtime - 1) / max(0.01, math.log(args.max_runtime))
+        offset = 0.0
+        mean_cpus = (args.node_cpus + 1) / 2.0
+        for _ in range(args.jobs):
+            cpus = rng.randint(1, args.node_cpus)
+            runtime = int(round(args.max_runtime ** rng.random()))
+            jobs.append((offset, cpus, runtime))
+            offset += rng.expovariate(args.load * args.cpus / (mean_cpus * mean_runtime))
+    print("# %d jobs, %s" % (len(jobs), "replay of " + args.trace if args.trace else "synthetic"))
+    print("t0=$(date +%s%N)")
+    print("at() {")
+    print("    local ms=$(( $1 - ($(date +%s%N) - t0) / 1000000 ))")
+    print("    [ $ms -le 0 ] || sleep $((ms / 1000)).$(printf %03d $((ms % 1000)))")
+    print("}")
+    for offset, cpus, runtime in jobs:
+        # Users overestimate: the limit is 1-4 times the runtime, in minutes.
+        limit = max(1, int((runtime * rng.uniform(1, 4) + 59) // 60))
+        print("at %d; sbatch --job-name=%s --output=/dev/null -n %d --time=%d --wrap='sleep %d' > /dev/null"
+              % (offset * 1000, args.name, cpus, limit, runtime))
+
+
+def objective(jobs, name, cpus):
+    key = OBJECTIVES[name][0]
+    result = analyze(jobs, cpus)
+    return result["all"].get(key, 0.0) if jobs else float("nan")
+
+
+def load_scores(path):
+    """[(rung, id, jobs, value)] of scores.txt."""
+    scores = []
+    with open(path) as f:
+        for line in f:
+            rung, cid, jobs, value = line.split()
+            scores.append((int(rung), cid, int(jobs), float(value)))
+    return scores
+
+
+def ranked(scores, name):
+    """Best first; a NaN score (a replay without sacct records) is last."""
+    sign = -1 if OBJECTIVES[name][1] == "higher" else 1
+    return sorted(scores, key=lambda s: (math.isnan(s[3]), 0.0 if math.isnan(s[3]) else sign * s[3]))
+
+
+def bootstrap(runs, name, cpus, rng):
+    """Confidence interval of the objective, averaged over runs: the jobs of
+    every run are resampled with replacement."""
+    values = []
+    for _ in range(BOOTSTRAP):
+        per_run = [objective([rng.choice(jobs) for _ in jobs], name, cpus) for jobs in runs if jobs]
+        if not per_run:
+            return float("nan"), float("nan")
+        values.append(sum(per_run) / len(per_run))
+    values.sort()
+    tail = (100 - CONFIDENCE) / 2.0
+    return percentile(values, tail), percentile(values, 100 - tail)
+
+
+def report(args):
+    with open(os.path.join(args.out, "candidates.json")) as f:
+        candidates = json.load(f, object_pairs_hook=OrderedDict)
+    path = os.path.join(args.out, "scores.txt")
+    scores = load_scores(path) if os.path.exists(path) else []
+
+    if scores:
+        print("%-6s %6s  %s" % ("rung", "jobs", "candidates (best first)"))
+    for rung in sorted(set(s[0] for s in scores)):
+        rows = ranked([s for s in scores if s[0] == rung], args.objective)
+        print("%-6d %6d  %s" % (rung, rows[0][2], "  ".join("%s=%.3g" % (s[1], s[3]) for s in rows)))
+    print()
+
+    final = os.path.join(args.out, "final")
+    runs = OrderedDict()
+    for name in sorted(os.listdir(final)):
+        cid = name.rsplit("-", 1)[0]
+        runs.setdefault(cid, []).append(read_jobs(os.path.join(final, name)))
+    winner = [c for c in runs if c != DEFAULT][0] if len(runs) > 1 else DEFAULT
+    rng = random.Random(args.seed)
+    print("%-10s %8s %12s %24s" % ("candidate", "replays", args.objective, "%d%% confidence interval" % CONFIDENCE))
+    results = OrderedDict()
+    for cid, jobs in runs.items():
+        mean = sum(objective(j, args.objective, args.cpus) for j in jobs) / len(jobs)
+        lo, hi = bootstrap(jobs, args.objective, args.cpus, rng)
+        results[cid] = (mean, lo, hi)
+        print("%-10s %8d %12.3f %11.3f .. %-10.3f" % (cid, len(jobs), mean, lo, hi))
+    if winner != DEFAULT and math.isnan(results[winner][0]):
+        sys.stderr.write("autotune.py: %s has no sacct records in its final replays, keeping default\n" % winner)
+        winner = DEFAULT
+    if winner != DEFAULT and DEFAULT in runs:
+        waits = [[j["start"] - j["submit"] for run in runs[cid] for j in run] for cid in (DEFAULT, winner)]
+        base, best = results[DEFAULT][0], results[winner][0]
+        print("%s against default: %+.1f%%, job waits p=%.3g (Mann-Whitney)" % (
+            winner, 100.0 * (best - base) / abs(base) if base else 0.0, mann_whitney(*waits)))
+    print()
+    mean, lo, hi = results[winner]
+    print("# autotune.sh: %s = %.3f (%d%% CI %.3f .. %.3f) over %d replays of %s" % (
+        args.objective, mean, CONFIDENCE, lo, hi, len(runs[winner]), args.out))
+    print(fragment(candidates[winner]) if winner != DEFAULT else "# the base slurm.conf is best")
+
+    if args.record:
+        for cid, jobs in runs.items():
+            label = DEFAULT if cid == DEFAULT else "best"
+            record(args.record, "%s/%s" % (label, args.objective),
+                   [objective(j, args.objective, args.cpus) for j in jobs])
+            record(args.record, "%s/wait_s" % label,
+                   [j["start"] - j["submit"] for run in jobs for j in run], "s")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command")
+
+    p = sub.add_parser("candidates", help="sample the candidates")
+    p.add_argument("--space", help="JSON file of the search space (default: SPACE)")
+    p.add_argument("-n", type=int, default=16, help="number of candidates besides default")
+    p.add_argument("--seed", type=int, default=42)
+
+    p = sub.add_parser("workload", help="print the workload as a bash script")
+    p.add_argument("--cpus", type=int, required=True, help="CPUs in the cluster")
+    p.add_argument("--node-cpus", type=int, default=1, help="largest job in CPUs")
+    p.add_argument("--jobs", type=int, default=100)
+    p.add_argument("--load", type=float, default=1.0, help="offered load, a fraction of the CPUs")
+    p.add_argument("--max-runtime", type=int, default=120, help="seconds")
+    p.add_argument("--trace", help="sacct records to replay (workload_stats.py format)")
+    p.add_argument("--speedup", type=float, default=10.0, help="time compression of --trace")
+    p.add_argument("--name", default="tune", help="job name")
+    p.add_argument("--seed", type=int, default=42)
+
+    p = sub.add_parser("fragment", help="print the slurm.conf fragment of a candidate")
+    p.add_argument("candidates")
+    p.add_argument("id")
+
+    p = sub.add_parser("score", help="print the objective of a replay")
+    p.add_argument("sacct")
+    p.add_argument("--objective", choices=OBJECTIVES, default="mean_wait")
+    p.add_argument("--cpus", type=int, required=True)
+
+    p = sub.add_parser("promote", help="print the best KEEP candidates of a rung and default")
+    p.add_argument("scores")
+    p.add_argument("rung", type=int)
+    p.add_argument("--objective", choices=OBJECTIVES, default="mean_wait")
+    p.add_argument("--keep", type=int, required=True)
+
+    p = sub.add_parser("report", help="print the results and the best fragment")
+    p.add_argument("out")
+    p.add_argument("--objective", choices=OBJECTIVES, default="mean_wait")
+    p.add_argument("--cpus", type=int, required=True)
+    p.add_argument("--record", metavar="DIR", help="record the final replays for DIR's run")
+    p.add_argument("--seed", type=int, default=42)
+
+    args = parser.parse_args()
+    if args.command == "candidates":
+        space = SPACE
+        if args.space:
+            with open(args.space) as f:
+                space = json.load(f, object_pairs_hook=OrderedDict)
+        rng = random.Random(args.seed)
+        candidates = OrderedDict([(DEFAULT, OrderedDict())])
+        seen = set()
+        for i in itertools.count(1):
+            if len(candidates) > args.n or i > 100 * args.n:
+                break
+            params = sample(space, rng)
+            if fragment(params) not in seen:
+                seen.add(fragment(params))
+                candidates["t%02d" % len(candidates)] = params
+        print(json.dumps(candidates, indent=2))
+    elif args.command == "workload":
+        workload(args)
+    elif args.command == "fragment":
+        with open(args.candidates) as f:
+            print(fragment(json.load(f, object_pairs_hook=OrderedDict)[args.id]))
+    elif args.command == "score":
+        print("%.6f" % objective(read_jobs(args.sacct), args.objective, args.cpus))
+    elif args.command == "promote":
+        rows = ranked([s for s in load_scores(args.scores) if s[0] == args.rung and s[1] != DEFAULT],
+                      args.objective)
+        for s in rows:
+            if math.isnan(s[3]):
+                sys.stderr.write("autotune.py: rung %d: %s has no score, dropped\n" % (s[0], s[1]))
+        rows = [s for s in rows if not math.isnan(s[3])]
+        print(" ".join([s[1] for s in rows[:args.keep]] + [DEFAULT]))
+    elif args.command == "report":
+        report(args)
+    else:
+        parser.print_help()
+        sys.exit(2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+#!/bin/bash
+#
+# Scheduler autotuning by successive halving (autotune.py): sample
+# CANDIDATES settings of SchedulerParameters, PriorityWeight* and friends,
+# replay a short prefix of the workload with each, keep the best 1/ETA and
+# replay a longer prefix with those, until one is left.  The winner and the
+# base slurm.conf ("default", replayed in every rung for comparison) then
+# replay the whole workload REPEATS times.  The summary ends with the
+# winner's slurm.conf fragment and the confidence interval of the
+# objective, also written to best.conf.
+#
+# The workload is synthetic (-j JOBS at offered load -l) or replays the
+# sacct records of an earlier run (-w, e.g. licenses.sh's *.sacct), sped up
+# by -x.  Rung r replays JOBS / ETA^(last rung - r) jobs, at least
+# MIN_JOBS.  Every replay restarts slurmctld and the nodes with the
+# candidate's fragment (written to profiles/autotune/slurm.conf), so one
+# replay runs at a time.
+#
+#     ./benchmarks/autotune.sh [-o mean_wait|bounded_slowdown|utilization] [-n CANDIDATES]
+#         [-e ETA] [-j JOBS] [-l LOAD] [-w SACCT_FILE] [-x SPEEDUP] [-r REPEATS] [-s SPACE_FILE]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+OBJECTIVE=mean_wait
+CANDIDATES=16
+ETA=2
+JOBS=80
+LOAD=1.0
+TRACE=""
+SPEEDUP=10
+REPEATS=3
+SPACE=""
+MIN_JOBS=10
+TUNE_DIR="${PROFILES_DIR}/autotune"
+
+usage="usage: $0 [-o OBJECTIVE] [-n CANDIDATES] [-e ETA] [-j JOBS] [-l LOAD] [-w SACCT_FILE] [-x SPEEDUP] [-r REPEATS] [-s SPACE_FILE]"
+while getopts "o:n:e:j:l:w:x:r:s:" opt
+do
+    case "$opt" in
+        o) OBJECTIVE=$OPTARG ;;
+        n) CANDIDATES=$OPTARG ;;
+        e) ETA=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        l) LOAD=$OPTARG ;;
+        w) TRACE=$OPTARG ;;
+        x) SPEEDUP=$OPTARG ;;
+        r) REPEATS=$OPTARG ;;
+        s) SPACE=$OPTARG ;;
+        *) echo "$usage" >&2; exit 2 ;;
+    esac
+done
+[ "$ETA" -ge 2 ] || die "ETA must be at least 2"
+
+OUT=$(output_dir autotune)
+trap 'rm -rf "$TUNE_DIR"; ctld scancel -u root 2> /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+CPUS=$(total_cpus)
+NODE_CPUS=$(ctld sinfo -h -o %c | sort -n | head -1)
+python3 "${BENCH_DIR}/autotune.py" candidates -n "$CANDIDATES" ${SPACE:+--space "$SPACE"} \
+    > "${OUT}/candidates.json"
+python3 "${BENCH_DIR}/autotune.py" workload --cpus "$CPUS" --node-cpus "$NODE_CPUS" \
+    --jobs "$JOBS" --load "$LOAD" ${TRACE:+--trace "$TRACE" --speedup "$SPEEDUP"} \
+    > "${OUT}/workload.sh"
+total=$(grep -c '^at ' "${OUT}/workload.sh")
+
+# Replay the first $2 jobs of the workload with candidate $1 and write their
+# sacct records to $3.
+replay() {
+    mkdir -p "$TUNE_DIR"
+    python3 "${BENCH_DIR}/autotune.py" fragment "${OUT}/candidates.json" "$1" > "${TUNE_DIR}/slurm.conf"
+    slurm_conf_apply autotune
+    slurm_restart
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+    local start
+    start=$(date -u +%Y-%m-%dT%H:%M:%S)
+    awk -v n="$2" '!/^at / || ++i <= n' "${OUT}/workload.sh" | ctld bash -s
+    wait_for_empty_queue
+    wait_for_dbd_agent
+    ctld sacct -a -n -P -X -S "$start" --name=tune -o JobID,JobName,Submit,Start,End,AllocCPUS,State > "$3"
+}
+
+ids=$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))))' "${OUT}/candidates.json")
+left=$(( $(echo "$ids" | wc -w) - 1 ))
+last=0
+n=$left
+while [ "$n" -gt 1 ]
+do
+    n=$(( (n + ETA - 1) / ETA ))
+    last=$((last + 1))
+done
+info "${left} candidates, ${CPUS} CPUs, ${total} jobs, $((last + 1)) rungs"
+
+rung=0
+while [ "$left" -gt 1 ]
+do
+    jobs=$(( total / ETA ** (last - rung) ))
+    [ "$jobs" -ge "$MIN_JOBS" ] || jobs=$(( MIN_JOBS < total ? MIN_JOBS : total ))
+    mkdir -p "${OUT}/rung-${rung}"
+    for id in $ids
+    do
+        log "rung ${rung}: ${id} (${jobs} jobs) ..."
+        replay "$id" "$jobs" "${OUT}/rung-${rung}/${id}.sacct"
+        score=$(python3 "${BENCH_DIR}/autotune.py" score --objective "$OBJECTIVE" \
+            --cpus "$CPUS" "${OUT}/rung-${rung}/${id}.sacct")
+        [ "$score" != nan ] || info "rung ${rung}: ${id} has no sacct records, ranked last"
+        echo "${rung} ${id} ${jobs} ${score}" >> "${OUT}/scores.txt"
+    done
+    left=$(( (left + ETA - 1) / ETA ))
+    ids=$(python3 "${BENCH_DIR}/autotune.py" promote --objective "$OBJECTIVE" --keep "$left" \
+        "${OUT}/scores.txt" "$rung")
+    rung=$((rung + 1))
+done
+
+mkdir -p "${OUT}/final"
+for i in $(seq "$REPEATS")
+do
+    for id in $ids
+    do
+        log "final ${i} of ${REPEATS}: ${id} (${total} jobs) ..."
+        replay "$id" "$total" "${OUT}/final/${id}-${i}.sacct"
+    done
+done
+
+python3 "${BENCH_DIR}/autotune.py" report --objective "$OBJECTIVE" --cpus "$CPUS" --record "$OUT" "$OUT" \
+    | tee "${OUT}/summary.txt"
+sed -n '/^# autotune.sh:/,$p' "${OUT}/summary.txt" > "${OUT}/best.conf"
@@ -0,0 +1,89 @@
+#!/bin/bash
+#
+# slurmdbd commit latency while the accounting database is backed up.
+#
+# For each backup variant a stream of jobs is submitted for as long as the
+# backup runs (at least JOBS jobs) and the mean slurmdbd commit time is read
+# from `sacctmgr show stats`.  Requires the backup profile and, for realistic
+# sizes, a seeded database:
+#
+#     ./benchmarks/seed_accounting.sh -n 1000000
+#     PROFILES=backup ./profiles/backup/setup.sh
+#     PROFILES=backup ./benchmarks/backup_load.sh [-n JOBS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=200
+
+while getopts "n:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir backup_load)
+
+log "Building the backup image ..."
+compose --profile backup build mysql-backup > /dev/null
+
+# name mode throttle rate
+VARIANTS="none - 0 0
+logical logical 0 0
+logical-throttled logical 0 20m
+physical physical 0 0
+physical-throttled physical 10 0"
+
+# Read the variants from fd 3: docker exec -i would consume stdin.
+while read -r name mode throttle rate <&3
+do
+    log "Variant ${name} ..."
+    wait_for_dbd_agent
+    dbd_stats_clear
+    start=$(now_ms)
+    pid=
+    if [ "$mode" != "-" ]
+    then
+        compose --profile backup run --rm -e BACKUP_THROTTLE="$throttle" \
+            -e BACKUP_RATE="$rate" -e BACKUP_KEEP=1 mysql-backup backup "$mode" \
+            > "${OUT}/${name}.log" 2>&1 < /dev/null &
+        pid=$!
+    fi
+
+    submitted=0
+    while [ "$submitted" -lt "$JOBS" ] || { [ -n "$pid" ] && kill -0 "$pid" 2> /dev/null; }
+    do
+        t=$(now_ms)
+        submit --output=/dev/null --wrap=true > /dev/null
+        echo "${name} $(( $(now_ms) - t ))" >> "${OUT}/submit.txt"
+        submitted=$((submitted + 1))
+    done
+    [ -z "$pid" ] || wait "$pid"
+    backup_ms=$(( $(now_ms) - start ))
+
+    wait_for_empty_queue
+    wait_for_dbd_agent
+    dbd_stats "$name" >> "${OUT}/dbd.json"
+    echo "${name} ${submitted} ${backup_ms}" >> "${OUT}/variants.txt"
+done 3<<< "$VARIANTS"
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[2])
+from stats import record
+out = sys.argv[1]
+variants = {}
+for line in open(os.path.join(out, "variants.txt")):
+    name, jobs, ms = line.split()
+    variants[name] = (int(jobs), int(ms))
+print("%-20s %8s %12s %12s" % ("variant", "jobs", "elapsed s", "commit us"))
+for line in open(os.path.join(out, "dbd.json")):
+    run = json.loads(line)
+    jobs, ms = variants[run["label"]]
+    print("%-20s %8d %12.1f %12.0f" % (run["label"], jobs, ms / 1000.0, run["commit"]["ave_us"]))
+    record(out, "%s/commit_us" % run["label"], [run["commit"]["ave_us"]], "us")
+PY
+echo "Submit latency (ms):" | tee -a "${OUT}/summary.txt"
+python3 "${BENCH_DIR}/stats.py" --by-key --unit ms --record "$OUT" "${OUT}/submit.txt" | tee -a "${OUT}/summary.txt"
@@ -0,0 +1,187 @@
+#!/bin/bash
+#
+# Find the Slurm commit that made a benchmark metric worse: `git bisect` a
+# clone of Slurm between a GOOD and a BAD commit, building an image of every
+# commit it picks and running the benchmark on a fresh cluster.
+#
+# A commit is bad when the median of METRIC is worse than THRESHOLD, in the
+# direction of the metric's `better` (see stats.py).  Without -t, GOOD and
+# BAD are measured first and the threshold is the midpoint of the two.
+# Commits that do not build are skipped.
+#
+# The images (slurm-docker-cluster:bisect-<commit>) share every layer up to
+# the Slurm build with each other, and their builds share the clone of the
+# Dockerfile's build stage.  They are built with BUILD_JOBS parallel make
+# jobs (default: all CPUs).  As with matrix.sh the cluster runs as its own
+# compose project (slurm-bisect) with fresh volumes, so the cluster's
+# containers must be removed first (`docker-compose down`, which keeps the
+# volumes).  The Slurm clone on the host that is bisected is kept in
+# SLURM_SRC (default .slurm-src).
+#
+#     ./benchmarks/bisect.sh -g slurm-19-05-1-2 -b slurm-19-05-8-1 \
+#         -m end-to-end_ms [-t THRESHOLD] -- job_lifecycle.sh -n 200
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+SLURM_REPO=${SLURM_REPO:-https://github.com/SchedMD/slurm.git}
+SLURM_SRC=${SLURM_SRC:-${ROOT_DIR}/.slurm-src}
+export COMPOSE_PROJECT_NAME=slurm-bisect
+
+# Build the image of commit $1, run the benchmark on it and print the median
+# of the metric, its direction and the number of samples.  Return 125 if the
+# commit does not build.
+measure() {
+    local commit=$1
+    local runs="${BISECT_OUT}/runs/${commit}"
+    export IMAGE_TAG="bisect-${commit}"
+
+    log "Building slurm-docker-cluster:${IMAGE_TAG} ..." >&2
+    if ! docker build --build-arg SLURM_REPO="$SLURM_REPO" --build-arg SLURM_TAG="$commit" \
+        --build-arg BUILD_JOBS="${BUILD_JOBS:-}" -t "slurm-docker-cluster:${IMAGE_TAG}" "$ROOT_DIR" \
+        > "${BISECT_OUT}/build-${commit}.log" 2>&1
+    then
+        info "${commit} does not build, see ${BISECT_OUT}/build-${commit}.log" >&2
+        return 125
+    fi
+
+    log "Running ${BISECT_BENCHMARK} on ${commit} ..." >&2
+    compose up -d > /dev/null
+    wait_for_mysql
+    ensure_cluster_registered > /dev/null
+    wait_for_slurmctld
+    wait_for_nodes
+    mkdir -p "$runs"
+    # Word splitting of the benchmark arguments is intended.
+    RESULTS_DIR="$runs" "${BENCH_DIR}/"$BISECT_BENCHMARK \
+        > "${BISECT_OUT}/bench-${commit}.log" 2>&1 \
+        || info "the benchmark failed on ${commit}, see ${BISECT_OUT}/bench-${commit}.log" >&2
+    compose down -v > /dev/null
+
+    python3 - "$runs" "$BISECT_METRIC" "$BENCH_DIR" <<'PY'
+import os, sys
+sys.path.insert(0, sys.argv[3])
+from report import load_run, pool
+from stats import percentile
+path, name = sys.argv[1], sys.argv[2]
+runs = [load_run(os.path.join(path, d)) for d in sorted(os.listdir(path))
+        if os.path.exists(os.path.join(path, d, "run.json"))]
+metric = pool(runs).get(name)
+if metric and metric["values"]:
+    print("%.6g %s %d" % (percentile(sorted(metric["values"]), 50), metric["better"],
+                          len(metric["values"])))
+PY
+}
+
+# Exit status of a `git bisect run` step for value $1 in direction $2:
+# 0 good, 1 bad.
+verdict() {
+    awk -v v="$1" -v better="$2" -v t="$BISECT_THRESHOLD" \
+        'BEGIN { exit (better == "higher" ? v < t : v > t) }'
+}
+
+# One `git bisect run` step on the commit checked out in SLURM_SRC.
+if [ "$1" = "--step" ]
+then
+    commit=$(git -C "$SLURM_SRC" rev-parse --short=12 HEAD)
+    subject=$(git -C "$SLURM_SRC" log -1 --format=%s HEAD)
+    status=0
+    result=$(measure "$commit") || status=$?
+    if [ "$status" -eq 125 ]
+    then
+        echo "${commit} - skip ${subject}" >> "${BISECT_OUT}/measurements.txt"
+        exit 125
+    fi
+    read -r value better samples <<< "$result"
+    if [ -z "$value" ]
+    then
+        info "no samples of ${BISECT_METRIC} on ${commit}" >&2
+        echo "${commit} - skip ${subject}" >> "${BISECT_OUT}/measurements.txt"
+        exit 125
+    fi
+    if verdict "$value" "$better"
+    then
+        status=0 state=good
+    else
+        status=1 state=bad
+    fi
+    info "${commit}: ${BISECT_METRIC} ${value} (${samples} samples), ${state}" >&2
+    echo "${commit} ${value} ${state} ${subject}" >> "${BISECT_OUT}/measurements.txt"
+    exit "$status"
+fi
+
+GOOD=""
+BAD=""
+METRIC=""
+THRESHOLD=""
+
+usage() {
+    echo "usage: $0 -g GOOD -b BAD -m METRIC [-t THRESHOLD] -- BENCHMARK [ARGS...]" >&2
+    exit 2
+}
+
+while getopts "g:b:m:t:" opt
+do
+    case "$opt" in
+        g) GOOD=$OPTARG ;;
+        b) BAD=$OPTARG ;;
+        m) METRIC=$OPTARG ;;
+        t) THRESHOLD=$OPTARG ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ -n "$GOOD" ] && [ -n "$BAD" ] && [ -n "$METRIC" ] && [ $# -gt 0 ] || usage
+
+require_project slurm-bisect
+
+if [ -d "${SLURM_SRC}/.git" ]
+then
+    log "Fetching ${SLURM_REPO} into ${SLURM_SRC} ..."
+    git -C "$SLURM_SRC" fetch -q --tags origin
+else
+    log "Cloning ${SLURM_REPO} into ${SLURM_SRC} ..."
+    git clone -q "$SLURM_REPO" "$SLURM_SRC"
+fi
+good=$(git -C "$SLURM_SRC" rev-parse --short=12 "${GOOD}^{commit}")
+bad=$(git -C "$SLURM_SRC" rev-parse --short=12 "${BAD}^{commit}")
+
+OUT=$(output_dir bisect)
+export BISECT_OUT=$OUT
+export BISECT_METRIC=$METRIC
+export BISECT_BENCHMARK="$*"
+trap 'compose down -v > /dev/null 2>&1; git -C "$SLURM_SRC" bisect reset > /dev/null 2>&1' EXIT
+info "$(git -C "$SLURM_SRC" rev-list --count "${good}..${bad}") commits between ${GOOD} and ${BAD}"
+
+if [ -z "$THRESHOLD" ]
+then
+    read -r good_value better samples <<< "$(measure "$good" || true)"
+    [ -n "$good_value" ] || die "no measurement of ${METRIC} on ${GOOD}"
+    read -r bad_value better samples <<< "$(measure "$bad" || true)"
+    [ -n "$bad_value" ] || die "no measurement of ${METRIC} on ${BAD}"
+    echo "${good} ${good_value} good ${GOOD}" >> "${OUT}/measurements.txt"
+    echo "${bad} ${bad_value} bad ${BAD}" >> "${OUT}/measurements.txt"
+    THRESHOLD=$(awk -v g="$good_value" -v b="$bad_value" 'BEGIN { printf "%.6g", (g + b) / 2 }')
+    BISECT_THRESHOLD=$THRESHOLD verdict "$bad_value" "$better" \
+        && die "${METRIC} is not worse on ${BAD} (${bad_value}) than on ${GOOD} (${good_value})"
+fi
+export BISECT_THRESHOLD=$THRESHOLD
+info "${METRIC} worse than ${THRESHOLD} is bad"
+
+git -C "$SLURM_SRC" bisect reset > /dev/null 2>&1 || true
+git -C "$SLURM_SRC" bisect start "$bad" "$good" > /dev/null
+git -C "$SLURM_SRC" bisect run "${BENCH_DIR}/bisect.sh" --step > "${OUT}/bisect_run.log" \
+    || die "git bisect run failed, see ${OUT}/bisect_run.log"
+git -C "$SLURM_SRC" bisect log > "${OUT}/bisect.log"
+first=$(git -C "$SLURM_SRC" rev-parse refs/bisect/bad)
+
+{
+    echo "First bad commit (${METRIC} worse than ${THRESHOLD}):"
+    git -C "$SLURM_SRC" log -1 --format='  %H%n  %an, %ad%n  %s' "$first"
+    echo
+    printf '%-12s %12s %-5s %s\n' commit "$METRIC" state subject
+    while read -r commit value state subject
+    do
+        printf '%-12s %12s %-5s %s\n' "$commit" "$value" "$state" "$subject"
+    done < "${OUT}/measurements.txt"
+} | tee "${OUT}/summary.txt"
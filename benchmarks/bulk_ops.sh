@@ -0,0 +1,126 @@
+#!/bin/bash
+#
+# Bulk job operations benchmark: mass hold/release, update, requeue and
+# cancel of individual jobs and of a job array on a full queue.
+#
+# The queue is filled with JOBS individual jobs and an array of JOBS tasks,
+# all deferred with --begin so that nothing starts.  Each operation is timed
+# while rpc_probe.py issues a small squeue RPC every PROBE_INTERVAL ms from
+# another client; the probe latency during the operation shows how long
+# other clients stall behind the slurmctld locks.  Scheduler cycle times
+# come from sdiag, reset before every operation.
+#
+# Job lists are passed to scontrol in chunks of CHUNK IDs, one per line of
+# stdin, since a single comma-joined argument of 20000 IDs can exceed the
+# kernel's 128 KiB limit per argument.  Operations that fail are marked in
+# the summary and not recorded.
+#
+#     ./benchmarks/bulk_ops.sh [-n JOBS] [-q REQUEUE_JOBS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=20000
+REQUEUE_JOBS=1000
+PROBE_INTERVAL=50
+CHUNK=5000
+
+while getopts "n:q:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        q) REQUEUE_JOBS=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-q REQUEUE_JOBS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir bulk_ops)
+trap 'ctld scancel -u root 2> /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+log "Raising MaxJobCount, MaxArraySize and MinJobAge ..."
+slurm_conf_apply large-queue keep-finished
+slurm_restart
+ctld scancel -u root 2> /dev/null || true
+wait_for_empty_queue
+
+# Time one operation on the controller: op LABEL COMMAND...  The command
+# reads op's stdin.
+op() {
+    local label=$1 start end rc=0
+    shift
+    sdiag_reset
+    start=$(now_ms)
+    ctld "$@" > /dev/null 2>> "${OUT}/errors.txt" || rc=$?
+    end=$(now_ms)
+    echo "${label} ${start} ${end} ${rc}" >> "${OUT}/ops.txt"
+    sdiag_json "$label" >> "${OUT}/sdiag.json"
+    if [ "$rc" -eq 0 ]
+    then
+        info "${label}: $((end - start)) ms"
+    else
+        info "${label}: failed (exit ${rc}), see errors.txt"
+    fi
+    # Let the probe record the recovery before the next operation.
+    sleep 2
+}
+
+log "Filling the queue with ${JOBS} jobs and a ${JOBS} task array ..."
+for i in $(seq "$JOBS")
+do
+    echo "sbatch --parsable --begin=now+1day --output=/dev/null --wrap=true"
+done > "${OUT}/fill.sh"
+submit_script "${OUT}/fill.sh" > "${OUT}/jobs.txt"
+awk -v n="$CHUNK" '{ printf "%s%s", (NR - 1) % n ? "," : "", $1 } NR % n == 0 { print "" }
+    END { if (NR % n) print "" }' "${OUT}/jobs.txt" > "${OUT}/chunks.txt"
+ARRAY=$(submit --array=0-$((JOBS - 1)) --begin=now+1day --output=/dev/null --wrap=true)
+
+log "Running ${REQUEUE_JOBS} short jobs to requeue once finished ..."
+for i in $(seq "$REQUEUE_JOBS")
+do
+    echo "sbatch --parsable --output=/dev/null --time=1 --wrap=true"
+done > "${OUT}/requeue.sh"
+submit_script "${OUT}/requeue.sh" > "${OUT}/requeue_jobs.txt"
+REQUEUE_LIST=$(paste -sd, "${OUT}/requeue_jobs.txt")
+wait_for_jobs "$REQUEUE_LIST"
+
+probe_start "${OUT}/probe.txt" squeue -h -j "$(head -1 "${OUT}/jobs.txt")"
+sleep 5
+op baseline true
+op hold xargs -I{} scontrol hold {} < "${OUT}/chunks.txt"
+op release xargs -I{} scontrol release {} < "${OUT}/chunks.txt"
+op update-jobs xargs -I{} scontrol update jobid={} TimeLimit=10 Comment=bulk < "${OUT}/chunks.txt"
+op hold-array scontrol hold "$ARRAY"
+op release-array scontrol release "$ARRAY"
+op update-array scontrol update jobid="$ARRAY" TimeLimit=10
+# Finished jobs stay requeueable for MinJobAge seconds (keep-finished).
+op requeue scontrol requeue "$REQUEUE_LIST"
+op cancel-array scancel "$ARRAY"
+op cancel-user scancel -u root
+probe_stop
+
+python3 - "$OUT" "$PROBE_INTERVAL" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[3])
+from stats import record
+out = sys.argv[1]
+probe = [tuple(float(v) for v in line.split()) for line in open(os.path.join(out, "probe.txt"))]
+sdiag = dict((s["label"], s) for s in (json.loads(l) for l in open(os.path.join(out, "sdiag.json"))))
+print("%-14s %10s %12s %12s %10s %14s %14s" % ("operation", "time ms", "probe p50", "probe max",
+                                            "probes", "main max us", "bf max us"))
+for line in open(os.path.join(out, "ops.txt")):
+    label, start, end, rc = line.split()
+    start, end = float(start), float(end)
+    if rc != "0":
+        print("%-14s %10s  (exit %s, see errors.txt)" % (label, "FAILED", rc))
+        continue
+    # Samples that overlap the operation, including one started before it.
+    window = sorted(lat for t, lat in probe if t <= end and t + lat >= start)
+    s = sdiag.get(label, {})
+    print("%-14s %10.0f %12.1f %12.1f %10d %14.0f %14.0f" % (
+        label, end - start, window[len(window) // 2] if window else 0,
+        window[-1] if window else 0, len(window),
+        s.get("main.max_cycle", 0), s.get("backfill.max_cycle", 0)))
+    record(out, "%s/time_ms" % label, [end - start], "ms")
+    record(out, "%s/probe_ms" % label, window, "ms")
+print("(probe: squeue of one job every %s ms from a second client)" % sys.argv[2])
+PY
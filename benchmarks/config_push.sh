@@ -0,0 +1,82 @@
+#!/bin/bash
+#
+# Configuration push time with the config-push profile (bin/slurm-config)
+# at increasing numbers of compute containers.
+#
+# Every repeat changes slurm.conf on the controller and runs `slurm-config
+# publish --wait N`: the time until all N containers have downloaded,
+# verified and switched to the new snapshot.  Afterwards every container's
+# slurm.conf is compared with the controller's.
+#
+#     ./benchmarks/config_push.sh [-s "2 50 200"] [-n REPEATS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+SIZES="2 50 200"
+REPEATS=20
+TIMEOUT=300
+
+while getopts "s:n:" opt
+do
+    case "$opt" in
+        s) SIZES=$OPTARG ;;
+        n) REPEATS=$OPTARG ;;
+        *) echo "usage: $0 [-s SIZES] [-n REPEATS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir config_push)
+trap 'compose up -d --remove-orphans > /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+for size in $SIZES
+do
+    log "Starting ${size} compute containers fetching their configuration ..."
+    "${ROOT_DIR}/generate_topology.py" --nodes "$size" --containers "$size" --config-server
+    # Publish the new node list before the containers start and fetch it.
+    compose --profile config-push up -d slurmctld > /dev/null
+    wait_for_slurmctld
+    slurm_conf_apply config-push topology
+    compose --profile config-push --profile topology up -d --remove-orphans > /dev/null
+    slurm_restart
+
+    for i in $(seq "$REPEATS")
+    do
+        ctld_sh "echo '# push ${i} of $(date +%s%N)' >> /etc/slurm/slurm.conf"
+        result=$(ctld slurm-config publish --wait "$size" --timeout "$TIMEOUT") \
+            || info "not every container acknowledged within ${TIMEOUT}s"
+        echo "${size} ${result}" >> "${OUT}/pushes.txt"
+        info "${size} containers: push $(echo "$result" | python3 -c 'import json, sys; print(json.load(sys.stdin)["push_ms"])') ms"
+    done
+
+    expected=$(ctld sha256sum /etc/slurm/slurm.conf | cut -d' ' -f1)
+    stale=0
+    for container in $(compute_containers)
+    do
+        [ "$(docker exec "$container" sha256sum /etc/slurm/slurm.conf | cut -d' ' -f1)" = "$expected" ] \
+            || stale=$((stale + 1))
+    done
+    echo "${size} ${stale}" >> "${OUT}/stale.txt"
+    info "${size} containers: ${stale} with a stale slurm.conf"
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out = sys.argv[1]
+rows = OrderedDict()
+for line in open(os.path.join(out, "pushes.txt")):
+    size, result = line.split(" ", 1)
+    result = json.loads(result)
+    if result["push_ms"] >= 0:
+        rows.setdefault("%s/push_ms" % size, []).append(result["push_ms"])
+    rows.setdefault("%s/ack_ms" % size, []).extend(result["acked_ms"].values())
+print(format_table(OrderedDict((k, summarize(v)) for k, v in rows.items())))
+for k, v in rows.items():
+    record(out, k, v, "ms")
+for line in open(os.path.join(out, "stale.txt")):
+    size, stale = line.split()
+    print("%s containers: %s with a stale slurm.conf" % (size, stale))
+PY
@@ -0,0 +1,146 @@
+#!/bin/bash
+#
+# Connection storms against slurmctld, once with the kernel defaults of a
+# CentOS 7 host (stock-sysctls profile) and once with the sysctls of
+# docker-compose.yml.  At every level of CONCURRENCY, storm.py runs that many
+# clients in c1 back to back for DURATION seconds (a held `sbatch` by
+# default, or the command after --), so only the server side differs
+# between the two runs.  Before and after each level the TCP counters of
+# /proc/net/netstat are read:
+#
+#   ListenOverflows, ListenDrops   slurmctld: connections dropped because
+#                                  its accept queue was full
+#   TCPSynRetrans                  c1: SYNs the clients had to send again
+#
+# along with the sockets in TIME_WAIT on both sides.  The summary has the
+# client latency, failed and retried calls, and the counter deltas.
+#
+#     ./benchmarks/conn_storm.sh [-c "CONCURRENCY..."] [-d DURATION] [-- COMMAND...]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+LEVELS="50 200 500"
+DURATION=20
+CLIENT=c1
+BASE_PROFILES=$PROFILES
+
+while getopts "c:d:" opt
+do
+    case "$opt" in
+        c) LEVELS=$OPTARG ;;
+        d) DURATION=$OPTARG ;;
+        *) echo "usage: $0 [-c \"CONCURRENCY...\"] [-d DURATION] [-- COMMAND...]" >&2; exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || set -- sbatch --hold --parsable --output=/dev/null --job-name=storm --wrap=true
+
+OUT=$(output_dir conn_storm)
+trap 'ctld scancel -u root 2> /dev/null; PROFILES=$BASE_PROFILES compose up -d > /dev/null 2>&1; slurm_conf_reset; slurm_restart' EXIT
+
+# "<name> <value>" of the TCP counters of container $1 and its sockets in
+# TIME_WAIT.
+tcp_counters() {
+    docker exec "$1" cat /proc/net/netstat /proc/net/tcp /proc/net/tcp6 2> /dev/null |
+        awk '$1 == "TcpExt:" && !names { for (i = 2; i <= NF; i++) name[i] = $i; names = 1; next }
+             $1 == "TcpExt:" { for (i = 2; i <= NF; i++) value[name[i]] = $i; next }
+             $4 == "06" { time_wait++ }
+             END {
+                 split("ListenOverflows ListenDrops TCPSynRetrans", keys, " ")
+                 for (k = 1; k <= 3; k++) print keys[k], value[keys[k]] + 0
+                 print "TIME_WAIT", time_wait + 0
+             }'
+}
+
+# Append the changes of the counters of container $1 since the snapshot $2,
+# labelled with the mode and level, to counters.txt; TIME_WAIT is the number
+# of sockets now.
+counter_deltas() {
+    join "$2" <(tcp_counters "$1" | sort) |
+        awk -v label="${mode} ${level} $1" '{ print label, $1, ($1 == "TIME_WAIT" ? $3 : $3 - $2) }' \
+        >> "${OUT}/counters.txt"
+}
+
+for mode in stock tuned
+do
+    if [ "$mode" = "stock" ]
+    then
+        PROFILES="${BASE_PROFILES} stock-sysctls"
+    else
+        PROFILES=$BASE_PROFILES
+    fi
+    log "${mode}: recreating the cluster ..."
+    compose up -d > /dev/null 2>&1
+    slurm_conf_apply large-queue
+    slurm_restart
+    for container in slurmctld "$CLIENT"
+    do
+        echo "${mode} ${container} $(docker exec "$container" sh -c \
+            'echo $(cat /proc/sys/net/core/somaxconn /proc/sys/net/ipv4/tcp_max_syn_backlog /proc/sys/net/ipv4/tcp_tw_reuse /proc/sys/net/ipv4/tcp_fin_timeout)')"
+    done >> "${OUT}/sysctls.txt"
+
+    for level in $LEVELS
+    do
+        ctld scancel -u root 2> /dev/null || true
+        wait_for_empty_queue
+        tcp_counters "$CONTROLLER" | sort > "${OUT}/.before-ctld"
+        tcp_counters "$CLIENT" | sort > "${OUT}/.before-client"
+
+        log "${mode}: ${level} concurrent clients for ${DURATION}s ..."
+        docker exec -i "$CLIENT" python3 - "$level" "$DURATION" "$@" \
+            < "${BENCH_DIR}/storm.py" > "${OUT}/storm-${mode}-${level}.txt"
+
+        counter_deltas "$CONTROLLER" "${OUT}/.before-ctld"
+        counter_deltas "$CLIENT" "${OUT}/.before-client"
+        info "${mode}/${level}: $(wc -l < "${OUT}/storm-${mode}-${level}.txt") calls"
+    done
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+done
+rm -f "${OUT}/.before-ctld" "${OUT}/.before-client"
+
+python3 - "$OUT" "$BENCH_DIR" "$LEVELS" "$CONTROLLER" "$CLIENT" <<'PY' | tee "${OUT}/summary.txt"
+import os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out, levels, ctld, client = sys.argv[1], sys.argv[3].split(), sys.argv[4], sys.argv[5]
+print("%-6s %-10s %10s %14s %12s %16s" % ("mode", "container", "somaxconn", "syn_backlog", "tw_reuse", "fin_timeout"))
+for line in open(os.path.join(out, "sysctls.txt")):
+    print("%-6s %-10s %10s %14s %12s %16s" % tuple(line.split()[:6]))
+print()
+
+counters = {}
+for line in open(os.path.join(out, "counters.txt")):
+    mode, level, container, name, value = line.split()
+    counters[(mode, level, container, name)] = int(value)
+
+rows = OrderedDict()
+print("%-6s %6s %8s %8s %8s %9s %9s %9s %10s %10s" % (
+    "mode", "conc", "calls", "calls/s", "failed", "retries", "overflow", "drops", "syn_retx", "time_wait"))
+for mode in ("stock", "tuned"):
+    for level in levels:
+        calls = [l.split() for l in open(os.path.join(out, "storm-%s-%s.txt" % (mode, level)))]
+        if not calls:
+            continue
+        latency = [float(c[1]) for c in calls]
+        failed = sum(1 for c in calls if c[2] != "0")
+        retries = sum(int(c[3]) for c in calls)
+        span = (max(int(c[0]) + float(c[1]) for c in calls) - min(int(c[0]) for c in calls)) / 1000.0
+        c = lambda container, name: counters.get((mode, level, container, name), 0)
+        print("%-6s %6s %8d %8.1f %8d %9d %9d %9d %10d %10d" % (
+            mode, level, len(calls), len(calls) / span if span else 0, failed, retries,
+            c(ctld, "ListenOverflows"), c(ctld, "ListenDrops"), c(client, "TCPSynRetrans"),
+            c(ctld, "TIME_WAIT") + c(client, "TIME_WAIT")))
+        key = "%s/c%s" % (mode, level)
+        rows[key + "/latency_ms"] = latency
+        record(out, key + "/failed", [failed], "calls")
+        record(out, key + "/retries", [retries], "calls")
+        record(out, key + "/listen_overflows", [c(ctld, "ListenOverflows")], "connections")
+        record(out, key + "/syn_retransmits", [c(client, "TCPSynRetrans")], "segments")
+print()
+print(format_table(OrderedDict((k, summarize(v)) for k, v in rows.items())))
+for k, v in rows.items():
+    record(out, k, v, "ms")
+PY
@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# Run a benchmark with a durable and with an ephemeral accounting database
+# to separate the database cost from the scheduler cost.  The summaries of
+# both runs are printed side by side and the database is left in the mode
+# it was in before.
+#
+#     ./benchmarks/db_cost.sh ./benchmarks/job_lifecycle.sh -n 100
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+[ -n "$1" ] || { echo "usage: $0 BENCHMARK [ARGS...]" >&2; exit 2; }
+
+OUT=$(output_dir db_cost)
+ORIGINAL=$(db_mode)
+trap 'db_mode_switch "$ORIGINAL"' EXIT
+
+for mode in durable ephemeral
+do
+    log "Running $(basename "$1") with a ${mode} database ..."
+    db_mode_switch "$mode"
+    RESULTS_DIR="${OUT}/${mode}" "$@"
+done
+
+for mode in durable ephemeral
+do
+    echo "=== ${mode}"
+    cat "${OUT}/${mode}"/*/summary.txt
+done | tee "${OUT}/summary.txt"
@@ -0,0 +1,16 @@
+#!/bin/bash
+#
+# Switch the accounting database between durable (var_lib_mysql volume) and
+# ephemeral (tmpfs, relaxed durability) mode, or print the current mode.
+#
+#     ./benchmarks/db_mode.sh [durable|ephemeral]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+if [ -n "$1" ]
+then
+    log "Switching the accounting database to $1 mode ..."
+    db_mode_switch "$1"
+fi
+db_mode
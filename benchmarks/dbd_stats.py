@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Parse `sacctmgr show stats` into per-RPC slurmdbd latency.
+
+slurmdbd keeps a count and the total time of every RPC type it handled since
+the last `sacctmgr clear stats`.  The job and step start/complete RPCs are
+the accounting commits the controller waits on, so their average time is the
+commit latency the benchmarks report.
+
+    sacctmgr show stats | benchmarks/dbd_stats.py [--label NAME] [--json]
+"""
+
+import argparse
+import json
+import re
+import sys
+
+RPC_LINE = re.compile(r"^\s+(DBD_\w+|REQUEST_\w+|\w+)\s+\(\s*\d+\)\s+count:(\d+)\s+"
+                      r"ave_time:(\d+)\s+total_time:(\d+)")
+COMMIT_RPCS = ("DBD_JOB_START", "DBD_JOB_COMPLETE", "DBD_STEP_START",
+               "DBD_STEP_COMPLETE", "DBD_SEND_MULT_JOB_START", "DBD_SEND_MULT_MSG")
+
+
+def parse(text):
+    """Return {rpc: {"count", "ave_us", "total_us"}} for the by-type section."""
+    rpcs = {}
+    in_types = False
+    for line in text.splitlines():
+        if line.startswith("Remote Procedure Call statistics by message type"):
+            in_types = True
+            continue
+        if line and not line[0].isspace():
+            in_types = False
+        match = RPC_LINE.match(line)
+        if in_types and match:
+            rpcs[match.group(1)] = {
+                "count": int(match.group(2)),
+                "ave_us": int(match.group(3)),
+                "total_us": int(match.group(4)),
+            }
+    return rpcs
+
+
+def commit_summary(rpcs):
+    """Count and mean latency over the accounting commit RPCs."""
+    count = sum(rpcs[r]["count"] for r in COMMIT_RPCS if r in rpcs)
+    total = sum(rpcs[r]["total_us"] for r in COMMIT_RPCS if r in rpcs)
+    return {"count": count, "ave_us": total / count if count else 0.0}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--label", default="")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+
+    rpcs = parse(sys.stdin.read())
+    commits = commit_summary(rpcs)
+    if args.json:
+        print(json.dumps({"label": args.label, "commit": commits, "rpcs": rpcs}))
+        return
+    prefix = args.label + " " if args.label else ""
+    for name in sorted(rpcs):
+        print("%s%-28s count:%-8d ave_us:%d" % (prefix, name, rpcs[name]["count"],
+                                               rpcs[name]["ave_us"]))
+    print("%s%-28s count:%-8d ave_us:%.0f" % (prefix, "commit (job/step RPCs)",
+                                             commits["count"], commits["ave_us"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+#!/bin/bash
+#
+# Cost of AccountingStorageEnforce=associations,limits,qos,safe on the
+# submit path and in the scheduler as the association hierarchy grows.
+#
+# The first round runs without enforcement; every following round loads a
+# larger "bench" hierarchy (DEPTH:BRANCHING:USERS per leaf), enables the
+# enforce profile and submits JOBS jobs as root round-robin into the leaf
+# accounts, where root's associations carry the per-user limits.
+# Reported: sbatch latency on the client, REQUEST_SUBMIT_BATCH_JOB time in
+# slurmctld and the main and backfill scheduler cycle times.
+#
+#     ./benchmarks/enforce_cost.sh [-n JOBS] [-w SECONDS] [-s "2:5:2 3:10:5 4:10:5"]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=500
+SETTLE=60
+SIZES="2:5:2 3:10:5 4:10:5"
+
+while getopts "n:w:s:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        w) SETTLE=$OPTARG ;;
+        s) SIZES=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-w SECONDS] [-s SIZES]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir enforce_cost)
+trap 'slurm_conf_reset; slurm_restart' EXIT
+
+run_round() {
+    local label=$1
+    local leaves=($(cat "${RESULTS_DIR}/associations/leaves.txt" 2> /dev/null))
+    local i account=()
+
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+    sdiag_reset
+    for i in $(seq "$JOBS")
+    do
+        if [ ${#leaves[@]} -gt 0 ]
+        then
+            account=(--account="${leaves[$((i % ${#leaves[@]}))]}")
+        fi
+        t=$(now_ms)
+        submit "${account[@]}" --output=/dev/null --wrap="sleep 600" > /dev/null
+        echo "${label} $(( $(now_ms) - t ))" >> "${OUT}/submit.txt"
+    done
+    # Let the main and backfill schedulers cycle over the queue.
+    sleep "$SETTLE"
+    sdiag_json "$label" >> "${OUT}/sdiag.json"
+    ctld scancel -u root
+}
+
+log "Round without enforcement ..."
+"${BENCH_DIR}/seed_associations.sh" -r > /dev/null
+rm -f "${RESULTS_DIR}/associations/leaves.txt"
+slurm_conf_apply
+slurm_restart
+run_round "off"
+
+slurm_conf_apply enforce
+for size in $SIZES
+do
+    IFS=: read -r depth branching users <<< "$size"
+    "${BENCH_DIR}/seed_associations.sh" -d "$depth" -b "$branching" -u "$users" \
+        | tee -a "${OUT}/associations.txt"
+    # Reload the association cache and apply the enforcement settings.
+    slurm_restart
+    assocs=$(ctld sacctmgr -n -P show assoc format=id | wc -l)
+    log "Round with enforcement, ${assocs} associations ..."
+    run_round "enforce-${assocs}"
+done
+
+"${BENCH_DIR}/seed_associations.sh" -r > /dev/null
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[2])
+from stats import record
+out = sys.argv[1]
+submit = {}
+for line in open(os.path.join(out, "submit.txt")):
+    label, ms = line.split()
+    submit.setdefault(label, []).append(float(ms))
+print("%-18s %12s %12s %14s %14s %14s" % ("round", "sbatch p50", "sbatch p99",
+                                          "submit rpc us", "main cycle us", "bf cycle us"))
+for line in open(os.path.join(out, "sdiag.json")):
+    s = json.loads(line)
+    values = sorted(submit.get(s["label"], [0]))
+    rpc = s["rpc"].get("REQUEST_SUBMIT_BATCH_JOB", {}).get("ave_us", 0)
+    print("%-18s %12.0f %12.0f %14d %14.0f %14.0f" % (
+        s["label"], values[len(values) // 2], values[int(len(values) * 0.99)],
+        rpc, s.get("main.mean_cycle", 0), s.get("backfill.mean_cycle", 0)))
+    record(out, "%s/sbatch_ms" % s["label"], submit.get(s["label"], []), "ms")
+PY
@@ -0,0 +1,72 @@
+#!/bin/bash
+#
+# Throughput of the Parquet exporter (export profile) on the seeded
+# accounting database, compared with pulling the same history through
+# `sacct --parsable2`.
+#
+#     ./benchmarks/seed_accounting.sh -n 1000000 -d 90
+#     ./benchmarks/export.sh [-n NEW_JOBS] [-d DAYS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+NEW_JOBS=1000
+DAYS=90
+
+while getopts "n:d:" opt
+do
+    case "$opt" in
+        n) NEW_JOBS=$OPTARG ;;
+        d) DAYS=$OPTARG ;;
+        *) echo "usage: $0 [-n NEW_JOBS] [-d DAYS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir export)
+SINCE=$(date -u -d "-$((DAYS + 1)) days" +%Y-%m-%d)
+
+export_run() {
+    compose --profile export run --rm -e EXPORT_CLUSTER="$CLUSTER" slurm-export "$@"
+}
+
+log "Building the exporter image ..."
+compose --profile export build slurm-export > /dev/null
+
+log "Full export ..."
+export_run --reset | tee "${OUT}/full.json"
+
+log "Incremental export after ${NEW_JOBS} new jobs ..."
+for i in $(seq "$NEW_JOBS")
+do
+    submit --output=/dev/null --wrap=true > /dev/null
+done
+wait_for_empty_queue
+wait_for_dbd_agent
+export_run | tee "${OUT}/incremental.json"
+
+log "No-op export ..."
+export_run | tee "${OUT}/noop.json"
+
+log "Same history through sacct --parsable2 ..."
+start=$(now_ms)
+rows=$(ctld sacct -a -n -P -S "$SINCE" -E now -o ALL | wc -l)
+elapsed=$(( $(now_ms) - start ))
+awk -v rows="$rows" -v ms="$elapsed" 'BEGIN { printf "{\"sacct_rows\": %d, \"elapsed_s\": %.3f}\n", rows, ms / 1000 }' \
+    | tee "${OUT}/sacct.json"
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[2])
+from stats import record
+out = sys.argv[1]
+print("%-12s %12s %12s %10s %12s" % ("run", "job rows", "step rows", "seconds", "rows/s"))
+for run in ("full", "incremental", "noop"):
+    r = json.load(open(os.path.join(out, run + ".json")))
+    print("%-12s %12d %12d %10.1f %12.0f" % (run, r.get("job_rows", 0), r.get("step_rows", 0),
+                                             r["elapsed_s"], r.get("job_rows_per_s", 0)))
+    record(out, "%s/elapsed_s" % run, [r["elapsed_s"]], "s")
+s = json.load(open(os.path.join(out, "sacct.json")))
+rate = s["sacct_rows"] / s["elapsed_s"] if s["elapsed_s"] else 0
+print("%-12s %12d %12s %10.1f %12.0f" % ("sacct", s["sacct_rows"], "(incl.)", s["elapsed_s"], rate))
+record(out, "sacct/elapsed_s", [s["elapsed_s"]], "s")
+PY
@@ -0,0 +1,93 @@
+#!/bin/bash
+#
+# Submission throughput through slurm-gateway (gateway profile) compared
+# with forking sbatch once per job.
+#
+#   sbatch      JOBS `sbatch` processes run one after another in one shell on
+#               the controller, as a portal forking sbatch does
+#   identical   JOBS identical jobs posted to the gateway in batches of
+#               BATCH by CLIENTS connections; coalesced into arrays
+#   distinct    the same with a different job name per job, so every job is
+#               its own sbatch, run by the gateway's bounded worker pool
+#
+# All jobs are deferred with --begin and cancelled after each run.  The
+# gateway submits as GATEWAY_USER (default portal), so its jobs are
+# cancelled as well as root's.
+#
+#     PROFILES=gateway ./benchmarks/gateway.sh [-n JOBS] [-b BATCH] [-c CLIENTS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=5000
+BATCH=100
+CLIENTS=4
+GATEWAY_URL=http://slurm-gateway:8000
+GATEWAY_USER=${GATEWAY_USER:-portal}
+
+while getopts "n:b:c:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        b) BATCH=$OPTARG ;;
+        c) CLIENTS=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-b BATCH] [-c CLIENTS]" >&2; exit 2 ;;
+    esac
+done
+
+# scancel -u takes a single user.
+cancel_jobs() {
+    ctld scancel -u root
+    ctld scancel -u "$GATEWAY_USER"
+}
+
+OUT=$(output_dir gateway)
+docker inspect slurm-gateway > /dev/null 2>&1 || die "the slurm-gateway container is not running; start the gateway profile"
+trap 'cancel_jobs 2> /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+log "Raising MaxJobCount ..."
+slurm_conf_apply large-queue
+slurm_restart
+cancel_jobs 2> /dev/null || true
+wait_for_empty_queue
+
+log "Forked sbatch: ${JOBS} jobs ..."
+for i in $(seq "$JOBS")
+do
+    echo "sbatch --parsable --begin=now+1day --output=/dev/null --time=1 --wrap=true"
+done > "${OUT}/fork.sh"
+start=$(now_ms)
+submit_script "${OUT}/fork.sh" > "${OUT}/fork_jobs.txt"
+end=$(now_ms)
+python3 - "$JOBS" "$start" "$end" "$(wc -l < "${OUT}/fork_jobs.txt")" <<'PY' >> "${OUT}/runs.json"
+import json, sys
+jobs, start, end, ids = int(sys.argv[1]), float(sys.argv[2]), float(sys.argv[3]), int(sys.argv[4])
+print(json.dumps({"mode": "sbatch", "jobs": jobs, "done_s": (end - start) / 1000.0,
+                  "jobs_per_s": jobs * 1000.0 / (end - start), "job_ids": ids, "errors": jobs - ids}))
+PY
+cancel_jobs
+wait_for_empty_queue
+
+for mode in identical distinct
+do
+    log "Gateway (${mode}): ${JOBS} jobs in batches of ${BATCH} over ${CLIENTS} connections ..."
+    docker exec -i slurm-gateway python3 - "$GATEWAY_URL" "$JOBS" "$BATCH" "$CLIENTS" "$mode" \
+        < "${BENCH_DIR}/gateway_client.py" >> "${OUT}/runs.json"
+    info "$(ctld squeue -h -r -o %i | wc -l) jobs queued"
+    cancel_jobs
+    wait_for_empty_queue
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[2])
+from stats import record
+print("%-10s %8s %10s %10s %10s %8s %12s" % ("mode", "jobs", "seconds", "jobs/s", "job IDs",
+                                             "errors", "batch p50"))
+for line in open(os.path.join(sys.argv[1], "runs.json")):
+    r = json.loads(line)
+    print("%-10s %8d %10.1f %10.1f %10d %8d %12s" % (
+        r["mode"], r["jobs"], r["done_s"], r["jobs_per_s"], r["job_ids"], r["errors"],
+        "%.0f ms" % r["batch_p50_ms"] if "batch_p50_ms" in r else "-"))
+    record(sys.argv[1], "%s/jobs_per_s" % r["mode"], [r["jobs_per_s"]])
+PY
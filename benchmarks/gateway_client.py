@@ -0,0 +1,96 @@
+"""Submit jobs through slurm-gateway and time them.
+
+Run inside a container on the cluster network (python3.4 from the image):
+
+    python3 - URL JOBS BATCH CLIENTS identical|distinct < gateway_client.py
+
+CLIENTS threads, each with one keep-alive connection, post batches of BATCH
+deferred jobs until JOBS jobs are posted, then collect their job IDs.
+Identical jobs can be coalesced into arrays by the gateway; distinct jobs
+differ in their name and cannot.  Prints one JSON object.
+"""
+
+import json
+import os
+import sys
+import threading
+import time
+from http.client import HTTPConnection
+from urllib.parse import urlparse
+
+SCRIPT = "#!/bin/bash\ntrue\n"
+# The gateway's token, from the environment of the slurm-gateway container.
+HEADERS = {"Authorization": "Bearer %s" % os.environ.get("GATEWAY_TOKEN", "")}
+
+
+def client(url, batches, mode, results, lock):
+    conn = HTTPConnection(url.hostname, url.port or 80, timeout=120)
+    posted = []
+    for first, size in batches:
+        jobs = []
+        for i in range(first, first + size):
+            options = {"begin": "now+1day", "output": "/dev/null", "time": "1"}
+            if mode == "distinct":
+                options["job-name"] = "gw%d" % i
+            jobs.append({"script": SCRIPT, "options": options})
+        start = time.time()
+        headers = dict(HEADERS, **{"Content-Type": "application/json"})
+        conn.request("POST", "/jobs", json.dumps({"jobs": jobs}), headers)
+        response = conn.getresponse()
+        body = json.loads(response.read().decode())
+        if response.status != 202:
+            raise RuntimeError(body.get("error"))
+        posted.append((body["batch"], start))
+    accepted = time.time()
+    latencies, ids, errors = [], 0, 0
+    for batch, start in posted:
+        while True:
+            conn.request("GET", "/batches/%s?wait=30" % batch, headers=HEADERS)
+            view = json.loads(conn.getresponse().read().decode())
+            if view["done"]:
+                break
+        latencies.append((time.time() - start) * 1000)
+        for job in view["jobs"]:
+            if "job_id" in job:
+                ids += 1
+            else:
+                errors += 1
+    with lock:
+        results.append((accepted, latencies, ids, errors))
+
+
+def main():
+    if len(sys.argv) != 6:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    url = urlparse(sys.argv[1])
+    jobs, batch, clients, mode = int(sys.argv[2]), int(sys.argv[3]), int(sys.argv[4]), sys.argv[5]
+    batches = [[] for _ in range(clients)]
+    for n, first in enumerate(range(0, jobs, batch)):
+        batches[n % clients].append((first, min(batch, jobs - first)))
+
+    results, lock = [], threading.Lock()
+    start = time.time()
+    threads = [threading.Thread(target=client, args=(url, b, mode, results, lock))
+               for b in batches if b]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    end = time.time()
+
+    latencies = sorted(l for r in results for l in r[1])
+    print(json.dumps({
+        "mode": mode, "jobs": jobs, "batch": batch, "clients": clients,
+        "accepted_s": max(r[0] for r in results) - start,
+        "done_s": end - start,
+        "jobs_per_s": jobs / (end - start),
+        "job_ids": sum(r[2] for r in results),
+        "errors": sum(r[3] for r in results),
+        "batch_p50_ms": latencies[len(latencies) // 2] if latencies else 0,
+        "batch_max_ms": latencies[-1] if latencies else 0,
+    }))
+
+
+if __name__ == "__main__":
+    main()
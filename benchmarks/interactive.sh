@@ -0,0 +1,81 @@
+#!/bin/bash
+#
+# Interactive allocation latency: time from `srun --pty bash` (or `salloc`)
+# to the first shell prompt, measured through a pseudo-terminal in the login
+# container (login profile).
+#
+# Scenarios:
+#   idle      empty cluster
+#   busy      BUSY low-priority background jobs keep the nodes and the
+#             scheduler busy; the interactive job has the higher priority
+#   prolog    idle cluster with PrologFlags=Alloc and a prolog that takes
+#             PROLOG_SECONDS
+#
+#     ./benchmarks/interactive.sh [-n ATTEMPTS] [-b BUSY] [-p PROLOG_SECONDS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+ATTEMPTS=20
+BUSY=1000
+PROLOG_SECONDS=0.5
+TIMEOUT=300
+SHELL_CMD="bash --norc --noprofile -i"
+
+while getopts "n:b:p:" opt
+do
+    case "$opt" in
+        n) ATTEMPTS=$OPTARG ;;
+        b) BUSY=$OPTARG ;;
+        p) PROLOG_SECONDS=$OPTARG ;;
+        *) echo "usage: $0 [-n ATTEMPTS] [-b BUSY] [-p PROLOG_SECONDS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir interactive)
+docker inspect login > /dev/null 2>&1 || die "the login container is not running; start the login profile"
+trap 'ctld scancel -u root 2> /dev/null; ctld rm -f /etc/slurm/prolog.d/50-bench-delay; slurm_conf_reset; slurm_reconfigure' EXIT
+
+# measure SCENARIO: every interactive command, ATTEMPTS times.
+measure() {
+    local scenario=$1 kind
+    for kind in srun salloc
+    do
+        case "$kind" in
+            srun) cmd="srun -N1 -n1 --pty ${SHELL_CMD}" ;;
+            salloc) cmd="salloc -N1 -n1 ${SHELL_CMD}" ;;
+        esac
+        info "${scenario}/${kind} ..."
+        docker exec -i login python3 - "$ATTEMPTS" "$TIMEOUT" $cmd \
+                < "${BENCH_DIR}/time_to_shell.py" \
+            | awk -v key="${scenario}/${kind}" '{ print key, $1 }' >> "${OUT}/latency.txt"
+    done
+}
+
+log "Idle cluster ..."
+slurm_conf_apply
+slurm_reconfigure
+ctld scancel -u root 2> /dev/null || true
+wait_for_empty_queue
+measure idle
+
+log "Busy cluster: ${BUSY} background jobs ..."
+for i in $(seq "$BUSY")
+do
+    echo "sbatch --nice=10000 --time=2 --output=/dev/null --wrap='sleep 20'"
+done > "${OUT}/busy.sh"
+submit_script "${OUT}/busy.sh" > /dev/null
+measure busy
+ctld scancel -u root
+wait_for_empty_queue
+
+log "PrologFlags=Alloc with a ${PROLOG_SECONDS}s prolog ..."
+ctld_sh "mkdir -p /etc/slurm/prolog.d && printf '#!/bin/sh\nsleep ${PROLOG_SECONDS}\n' > /etc/slurm/prolog.d/50-bench-delay && chmod +x /etc/slurm/prolog.d/50-bench-delay"
+slurm_conf_apply prolog-alloc
+slurm_reconfigure
+measure prolog
+
+{
+    echo "Time to first prompt (ms); $(grep -c timeout "${OUT}/latency.txt" || true) attempts timed out"
+    grep -v timeout "${OUT}/latency.txt" | python3 "${BENCH_DIR}/stats.py" --by-key --unit ms --record "$OUT"
+} | tee "${OUT}/summary.txt"
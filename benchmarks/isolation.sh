@@ -0,0 +1,123 @@
+#!/bin/bash
+#
+# Scheduler latency with idle and with fully loaded compute containers, once
+# with the control plane sharing all CPUs and once with the isolation profile
+# (control plane on CPUs of its own, see profiles/isolation/env.sh).
+#
+# Load is one job per node that keeps every CPU of its container busy (nproc
+# follows the container's cpuset) and, with -i, writes to /tmp with direct
+# I/O.  While idle and while loaded, rpc_probe.py times a held `sbatch`
+# every PROBE_INTERVAL ms for DURATION seconds, and sdiag gives the
+# scheduler cycles.  Latency is stable if the loaded percentiles stay close
+# to the idle ones.
+#
+#     ./benchmarks/isolation.sh [-d DURATION] [-i]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+DURATION=60
+IO_LOAD=0
+PROBE_INTERVAL=100
+BASE_PROFILES=$PROFILES
+
+while getopts "d:i" opt
+do
+    case "$opt" in
+        d) DURATION=$OPTARG ;;
+        i) IO_LOAD=1 ;;
+        *) echo "usage: $0 [-d DURATION] [-i]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir isolation)
+trap 'probe_stop 2> /dev/null; ctld scancel -u root 2> /dev/null; PROFILES=$BASE_PROFILES compose up -d > /dev/null 2>&1' EXIT
+
+BURN='for i in $(seq $(nproc)); do timeout '$((DURATION + 30))' sh -c "while :; do :; done" & done'
+if [ "$IO_LOAD" = 1 ]
+then
+    BURN="${BURN}"'; timeout '$((DURATION + 30))' sh -c "while :; do dd if=/dev/zero of=/tmp/burn bs=1M count=256 oflag=direct 2> /dev/null; done" &'
+fi
+BURN="${BURN}; wait; rm -f /tmp/burn"
+
+for mode in shared isolated
+do
+    if [ "$mode" = "isolated" ]
+    then
+        PROFILES="${BASE_PROFILES} isolation"
+    else
+        PROFILES=$BASE_PROFILES
+    fi
+    log "${mode}: recreating the cluster ..."
+    compose up -d > /dev/null 2>&1
+    wait_for_mysql
+    wait_for_slurmctld
+    wait_for_nodes
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+    for container in mysql slurmdbd slurmctld $(compute_containers)
+    do
+        echo "${mode} ${container} $(docker inspect -f '{{.HostConfig.CpusetCpus}} {{.HostConfig.BlkioWeight}}' "$container")"
+    done >> "${OUT}/containers.txt"
+
+    for load in idle loaded
+    do
+        if [ "$load" = "loaded" ]
+        then
+            log "${mode}: loading every compute container ..."
+            for node in $(compute_nodes)
+            do
+                echo "sbatch --parsable --output=/dev/null -w ${node} --wrap='${BURN}'"
+            done > "${OUT}/load.sh"
+            submit_script "${OUT}/load.sh" > /dev/null
+            until [ -z "$(ctld squeue -h -t pending -o %i)" ]
+            do
+                sleep 1
+            done
+            sleep 5
+        fi
+
+        log "${mode}: probing the scheduler (${load}) for ${DURATION}s ..."
+        sdiag_reset
+        probe_start "${OUT}/probe-${mode}-${load}.txt" \
+            sbatch --hold --parsable --output=/dev/null --job-name=probe --wrap=true
+        sleep "$DURATION"
+        probe_stop
+        sdiag_json "${mode}/${load}" >> "${OUT}/sdiag.json"
+        ctld scancel -u root
+        wait_for_empty_queue
+    done
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out = sys.argv[1]
+print("%-9s %-10s %-12s %s" % ("mode", "container", "cpuset", "blkio weight"))
+for line in open(os.path.join(out, "containers.txt")):
+    fields = line.split()
+    cpuset, weight = (fields[2], fields[3]) if len(fields) > 3 else ("all", fields[2])
+    print("%-9s %-10s %-12s %s" % (fields[0], fields[1], cpuset, weight))
+print()
+
+rows = OrderedDict()
+sdiag = dict((s["label"], s) for s in map(json.loads, open(os.path.join(out, "sdiag.json"))))
+for mode in ("shared", "isolated"):
+    for load in ("idle", "loaded"):
+        probe = os.path.join(out, "probe-%s-%s.txt" % (mode, load))
+        rows["%s/%s/submit_ms" % (mode, load)] = [float(l.split()[1]) for l in open(probe)]
+        s = sdiag.get("%s/%s" % (mode, load), {})
+        rows["%s/%s/main_max_cycle_ms" % (mode, load)] = [s.get("main.max_cycle", 0) / 1000.0]
+        rows["%s/%s/main_mean_cycle_ms" % (mode, load)] = [s.get("main.mean_cycle", 0) / 1000.0]
+summaries = OrderedDict((k, summarize(v)) for k, v in rows.items())
+print(format_table(summaries))
+for mode in ("shared", "isolated"):
+    idle, loaded = (summaries["%s/%s/submit_ms" % (mode, load)] for load in ("idle", "loaded"))
+    print("%s: loaded/idle submit latency p50 %.2fx, p99 %.2fx" % (
+        mode, loaded["p50"] / idle["p50"] if idle["p50"] else 0,
+        loaded["p99"] / idle["p99"] if idle["p99"] else 0))
+for k, v in rows.items():
+    record(out, k, v, "ms")
+PY
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Per-phase job lifecycle latency from a job_lifecycle.sh output directory.
+
+Events are taken from the most precise source available:
+
+    submit        slurmctld log (_slurm_rpc_submit_batch_job), else sacct Submit
+    eligible      sacct Eligible
+    scheduled     slurmctld log (sched: Allocate / backfill: Started)
+    launch        slurmd log (Launching batch job)
+    prolog_*      prolog hook
+    task_*        TaskProlog/TaskEpilog hooks
+    epilog_*      epilog hook
+    complete      slurmctld log (_job_complete ... done), else sacct End
+
+Each phase is the time between two consecutive events that were recorded for
+a job; missing events are skipped rather than guessed.
+"""
+
+import argparse
+import calendar
+import json
+import os
+import re
+import sys
+from collections import OrderedDict
+from datetime import datetime
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from stats import format_table, record, summarize  # noqa: E402
+
+EVENTS = [
+    "submit",
+    "eligible",
+    "scheduled",
+    "prolog_start",
+    "prolog_end",
+    "launch",
+    "task_start",
+    "task_end",
+    "epilog_start",
+    "epilog_end",
+    "complete",
+]
+
+LOG_LINE = re.compile(r"^\[(\d{4}-\d\d-\d\dT\d\d:\d\d:\d\d(?:\.\d+)?)\] (.*)$")
+
+CTLD_PATTERNS = [
+    ("submit", re.compile(r"_slurm_rpc_submit_batch_job:? JobId=(\d+)")),
+    ("scheduled", re.compile(r"sched: Allocate JobId=(\d+)")),
+    ("scheduled", re.compile(r"backfill: Started JobId=(\d+)")),
+    ("complete", re.compile(r"_job_complete: JobId=(\d+) done")),
+]
+
+SLURMD_PATTERNS = [
+    ("launch", re.compile(r"Launching batch job (\d+)")),
+]
+
+
+def parse_time(text):
+    """Container timestamps are UTC; return epoch seconds as a float."""
+    if "." in text:
+        stamp, frac = text.split(".")
+    else:
+        stamp, frac = text, "0"
+    tm = datetime.strptime(stamp, "%Y-%m-%dT%H:%M:%S").timetuple()
+    return calendar.timegm(tm) + float("0." + frac)
+
+
+def record(events, job, name, when):
+    # Keep the first occurrence (requeues and retries log again later).
+    events.setdefault(job, {}).setdefault(name, when)
+
+
+def read_log(path, patterns, jobs, events):
+    if not os.path.exists(path):
+        return
+    with open(path, errors="replace") as log:
+        for line in log:
+            match = LOG_LINE.match(line)
+            if not match:
+                continue
+            for name, pattern in patterns:
+                found = pattern.search(match.group(2))
+                if found and found.group(1) in jobs:
+                    record(events, found.group(1), name, parse_time(match.group(1)))
+
+
+def read_sacct(path, jobs, events):
+    with open(path) as sacct:
+        for line in sacct:
+            fields = line.rstrip("\n").split("|")
+            if len(fields) < 5 or fields[0] not in jobs:
+                continue
+            job, submit, eligible, _, end = fields[:5]
+            for name, value in (("submit", submit), ("eligible", eligible),
+                                ("complete", end)):
+                if value and value[0].isdigit():
+                    # Log timestamps are more precise; only fill gaps.
+                    record(events, job, name, parse_time(value))
+
+
+def read_hooks(path, jobs, events):
+    if not os.path.exists(path):
+        return
+    with open(path) as hooks:
+        for line in hooks:
+            fields = line.split()
+            if len(fields) >= 3 and fields[1] in jobs:
+                record(events, fields[1], fields[2], float(fields[0]))
+
+
+def phases(events):
+    """Return {phase: [milliseconds]} over all jobs."""
+    result = OrderedDict()
+    totals = []
+    for job_events in events.values():
+        present = [e for e in EVENTS if e in job_events]
+        for prev, cur in zip(present, present[1:]):
+            name = "%s -> %s" % (prev, cur)
+            delta = (job_events[cur] - job_events[prev]) * 1000.0
+            result.setdefault(name, []).append(delta)
+        if "submit" in job_events and "complete" in job_events:
+            totals.append((job_events["complete"] - job_events["submit"]) * 1000.0)
+    ordered = OrderedDict()
+    for prev in EVENTS:
+        for cur in EVENTS:
+            name = "%s -> %s" % (prev, cur)
+            if name in result:
+                ordered[name] = result[name]
+    if totals:
+        ordered["end-to-end"] = totals
+    return ordered
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dir", help="output directory of job_lifecycle.sh")
+    parser.add_argument("--json", action="store_true", help="print JSON")
+    parser.add_argument("--record", action="store_true",
+                        help="record the latencies with the run's results")
+    args = parser.parse_args()
+
+    with open(os.path.join(args.dir, "jobs.txt")) as f:
+        jobs = set(line.strip() for line in f if line.strip())
+
+    events = {}
+    read_log(os.path.join(args.dir, "slurmctld.log"), CTLD_PATTERNS, jobs, events)
+    read_log(os.path.join(args.dir, "slurmd.log"), SLURMD_PATTERNS, jobs, events)
+    read_hooks(os.path.join(args.dir, "hooks.log"), jobs, events)
+    read_sacct(os.path.join(args.dir, "sacct.txt"), jobs, events)
+
+    latencies = phases(events)
+    rows = OrderedDict((name, summarize(values)) for name, values in latencies.items())
+    if args.record:
+        for name, values in latencies.items():
+            record(args.dir, "%s_ms" % name, values, "ms")
+    if args.json:
+        print(json.dumps(rows, indent=2))
+    else:
+        print("%d jobs, latencies in ms" % len(events))
+        print(format_table(rows, label="phase"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,56 @@
+#!/bin/bash
+#
+# End-to-end job lifecycle latency breakdown.
+#
+# Submits a batch of short jobs with the lifecycle hooks enabled, then
+# correlates the slurmctld/slurmd logs, sacct and the hook timestamps of every
+# job and reports the latency distribution of each phase.
+#
+#     ./benchmarks/job_lifecycle.sh [-n JOBS] [-t SECONDS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=50
+RUNTIME=1
+
+while getopts "n:t:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        t) RUNTIME=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-t SECONDS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir job_lifecycle)
+
+log "Enabling the lifecycle hooks ..."
+slurm_conf_apply lifecycle
+slurm_reconfigure
+
+log "Submitting ${JOBS} jobs of ${RUNTIME}s ..."
+ids=()
+for i in $(seq "$JOBS")
+do
+    ids+=("$(submit --job-name=lifecycle --output=/dev/null --wrap="sleep ${RUNTIME}")")
+done
+joblist=$(IFS=,; echo "${ids[*]}")
+echo "$joblist" | tr ',' '\n' > "${OUT}/jobs.txt"
+
+log "Waiting for the jobs to complete ..."
+wait_for_jobs "$joblist"
+# The epilog and completion messages trail the end of the job.
+sleep 5
+
+log "Collecting timestamps into ${OUT} ..."
+ctld sacct -n -P -X -j "$joblist" -o JobID,Submit,Eligible,Start,End,State > "${OUT}/sacct.txt"
+ctld cat /var/log/slurm/slurmctld.log > "${OUT}/slurmctld.log"
+ctld cat /var/log/slurm/slurmd.log > "${OUT}/slurmd.log"
+ctld_sh "cat /var/log/slurm/lifecycle/*.log" > "${OUT}/hooks.log"
+
+log "Restoring slurm.conf ..."
+slurm_conf_reset
+slurm_reconfigure
+
+python3 "${BENCH_DIR}/job_lifecycle.py" --record "$OUT" | tee "${OUT}/summary.txt"
@@ -0,0 +1,398 @@
+#!/bin/bash
+#
+# Helpers shared by the benchmark scripts.  Source this file from a benchmark:
+#
+#     . "$(dirname "$0")/lib.sh"
+#
+# The benchmarks run on the Docker host and drive the cluster with
+# `docker exec` / `docker-compose`, the same way register_cluster.sh does.
+
+ROOT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)
+BENCH_DIR="${ROOT_DIR}/benchmarks"
+PROFILES_DIR="${ROOT_DIR}/profiles"
+RESULTS_DIR=${RESULTS_DIR:-${ROOT_DIR}/results}
+CONTROLLER=${CONTROLLER:-slurmctld}
+CLUSTER=$(sed -n 's/^ClusterName=//p' "${ROOT_DIR}/slurm.conf")
+# The benchmark command line, recorded with its results.
+BENCH_COMMAND="$(basename "$0") $*"
+
+# Space separated list of profiles (directories under profiles/) layered on
+# top of the base compose file and slurm.conf.
+PROFILES=${PROFILES:-}
+
+log() {
+    echo "---> $*"
+}
+
+info() {
+    echo "-- $*"
+}
+
+die() {
+    echo "ERROR: $*" >&2
+    exit 1
+}
+
+# Run a command on the controller container.
+ctld() {
+    docker exec -i "$CONTROLLER" "$@"
+}
+
+# Run a shell snippet on the controller container.
+ctld_sh() {
+    docker exec -i "$CONTROLLER" bash -c "$1"
+}
+
+# Run the mysql client against slurm_acct_db from the slurmdbd container,
+# with the credentials of slurmdbd.conf.
+acct_db() {
+    (
+        . "${ROOT_DIR}/slurmdbd.conf"
+        docker exec -i slurmdbd mysql -h "$StorageHost" -u"$StorageUser" \
+            -p"$StoragePass" -B -N "$StorageLoc" "$@"
+    )
+}
+
+# Die if containers of a compose project other than those matching the
+# pattern $1 exist, running or stopped.  The container names are fixed, so
+# a separate project (matrix.sh, bisect.sh, startup.sh) can only start once
+# the normal cluster's containers are removed; `docker-compose down` without
+# -v keeps its volumes.
+require_project() {
+    local container project
+    for container in mysql slurmdbd "$CONTROLLER" c1 c2
+    do
+        project=$(docker inspect -f '{{ index .Config.Labels "com.docker.compose.project" }}' \
+            "$container" 2> /dev/null || true)
+        case "$project" in
+            ""|$1) ;;
+            *) die "container ${container} of project ${project} exists; remove the cluster first with \`docker-compose down\` (without -v, which keeps the volumes)" ;;
+        esac
+    done
+}
+
+wait_for_mysql() {
+    until acct_db -e "SELECT 1" > /dev/null 2>&1
+    do
+        sleep 2
+    done
+}
+
+# Root password generated by a mysql container (MYSQL_RANDOM_ROOT_PASSWORD).
+mysql_root_password() {
+    docker logs "${1:-mysql}" 2>&1 | sed -n 's/.*GENERATED ROOT PASSWORD: //p' | tail -1
+}
+
+# docker-compose with the compose overrides of every profile in $PROFILES and
+# any profile passed with --profile NAME before the compose arguments.  The
+# variables of a profile's env.sh are exported for the compose files.
+compose() {
+    local files=(-f "${ROOT_DIR}/docker-compose.yml")
+    local envs=()
+    local profiles=($PROFILES)
+    while [ "$1" = "--profile" ]
+    do
+        profiles+=("$2")
+        shift 2
+    done
+    local p
+    for p in "${profiles[@]}"
+    do
+        if [ -f "${PROFILES_DIR}/${p}/docker-compose.yml" ]
+        then
+            files+=(-f "${PROFILES_DIR}/${p}/docker-compose.yml")
+        fi
+        if [ -f "${PROFILES_DIR}/${p}/env.sh" ]
+        then
+            envs+=("${PROFILES_DIR}/${p}/env.sh")
+        fi
+    done
+    (
+        set -a
+        for p in "${envs[@]}"
+        do
+            . "$p" || exit 1
+        done
+        docker-compose --project-directory "$ROOT_DIR" "${files[@]}" "$@"
+    )
+}
+
+# Milliseconds since the epoch.
+now_ms() {
+    date +%s%3N
+}
+
+# Create and print a fresh output directory for a benchmark run, with the
+# run.json that describes the run for report.py.
+output_dir() {
+    local dir="${RESULTS_DIR}/$1-$(date -u +%Y%m%dT%H%M%SZ)"
+    mkdir -p "$dir"
+    run_metadata "$1" > "${dir}/run.json" || die "cannot write ${dir}/run.json"
+    echo "$dir"
+}
+
+# Print what a run's results depend on as JSON: the image (SLURM_TAG and
+# build options from its labels), slurm.conf, the host and this repository.
+# The values reach python as environment variables, never as source text.
+run_metadata() {
+    local label='{{ index .Config.Labels "org.slurm-docker-cluster.%s" }}'
+    META_BENCHMARK="$1" \
+    META_COMMAND="$BENCH_COMMAND" \
+    META_STARTED="$(date -u +%Y-%m-%dT%H:%M:%SZ)" \
+    META_PROFILES="$PROFILES" \
+    META_SLURM_TAG="$(docker inspect -f "$(printf "$label" slurm-tag)" "$CONTROLLER" 2> /dev/null)" \
+    META_SLURM_VERSION="$(ctld sinfo -V 2> /dev/null)" \
+    META_CONFIGURE_EXTRA="$(docker inspect -f "$(printf "$label" configure-extra)" "$CONTROLLER" 2> /dev/null)" \
+    META_TARGET="$(docker inspect -f "$(printf "$label" target)" "$CONTROLLER" 2> /dev/null)" \
+    META_IMAGE="$(docker inspect -f '{{.Config.Image}}' "$CONTROLLER" 2> /dev/null)" \
+    META_IMAGE_ID="$(docker inspect -f '{{.Image}}' "$CONTROLLER" 2> /dev/null)" \
+    META_SLURM_CONF_SHA256="$(ctld sha256sum /etc/slurm/slurm.conf 2> /dev/null | cut -d' ' -f1)" \
+    META_COMPUTE_CONTAINERS="$(compute_containers 2> /dev/null | wc -l)" \
+    META_KERNEL="$(uname -srm)" \
+    META_CPUS="$(nproc)" \
+    META_MEM_KB="$(awk '/^MemTotal:/ { print $2 }' /proc/meminfo)" \
+    META_DOCKER="$(docker version -f '{{.Server.Version}}' 2> /dev/null)" \
+    META_REPO_COMMIT="$(git -C "$ROOT_DIR" describe --always --dirty 2> /dev/null)" \
+    python3 - <<'PY'
+import json, os
+env = lambda name: os.environ.get("META_" + name, "")
+number = lambda name: int(env(name) or 0)
+print(json.dumps({
+    "schema": 1,
+    "benchmark": env("BENCHMARK"),
+    "command": env("COMMAND"),
+    "started": env("STARTED"),
+    "profiles": env("PROFILES").split(),
+    "slurm_tag": env("SLURM_TAG"),
+    "slurm_version": env("SLURM_VERSION"),
+    "build": {
+        "configure_extra": env("CONFIGURE_EXTRA"),
+        "target": env("TARGET"),
+        "image": env("IMAGE"),
+        "image_id": env("IMAGE_ID"),
+    },
+    "slurm_conf_sha256": env("SLURM_CONF_SHA256"),
+    "compute_containers": number("COMPUTE_CONTAINERS"),
+    "host": {
+        "kernel": env("KERNEL"),
+        "cpus": number("CPUS"),
+        "mem_kb": number("MEM_KB"),
+        "docker": env("DOCKER"),
+    },
+    "repo_commit": env("REPO_COMMIT"),
+}, indent=2, sort_keys=True))
+PY
+}
+
+# Write the base slurm.conf followed by the slurm.conf fragment of each named
+# profile (and of every profile in $PROFILES) into the shared etc_slurm
+# volume.  Later settings override earlier ones.  A profile nodes.conf (see
+# generate_topology.py) replaces the NodeName and PartitionName lines of the
+# base slurm.conf.  The caller decides whether a `slurm_reconfigure` is
+# enough or the daemons need a `slurm_restart`.
+slurm_conf_apply() {
+    local p nodes=
+    for p in $PROFILES "$@"
+    do
+        if [ -f "${PROFILES_DIR}/${p}/nodes.conf" ]
+        then
+            nodes="${PROFILES_DIR}/${p}/nodes.conf"
+        fi
+    done
+    {
+        if [ -n "$nodes" ]
+        then
+            grep -Ev "^(NodeName|PartitionName)=" "${ROOT_DIR}/slurm.conf"
+            cat "$nodes"
+        else
+            cat "${ROOT_DIR}/slurm.conf"
+        fi
+        for p in $PROFILES "$@"
+        do
+            if [ -f "${PROFILES_DIR}/${p}/slurm.conf" ]
+            then
+                echo "#"
+                echo "# PROFILE: ${p}"
+                cat "${PROFILES_DIR}/${p}/slurm.conf"
+            fi
+        done
+    } | ctld_sh "cat > /etc/slurm/slurm.conf.new && mv /etc/slurm/slurm.conf.new /etc/slurm/slurm.conf"
+    # Keep track of the configurations a benchmark ran with.
+    if [ -n "$OUT" ]
+    then
+        echo "$(ctld sha256sum /etc/slurm/slurm.conf | cut -d' ' -f1) ${PROFILES} $*" >> "${OUT}/slurm_conf.txt"
+    fi
+    # Nodes of the config-push profile only see a published configuration.
+    ctld_sh '[ -z "$SLURM_CONFIG_SERVE" ] || slurm-config publish > /dev/null'
+}
+
+slurm_conf_reset() {
+    PROFILES= slurm_conf_apply
+}
+
+slurm_reconfigure() {
+    ctld scontrol reconfigure
+    wait_for_slurmctld
+}
+
+slurm_restart() {
+    compose restart slurmctld $(compute_containers) > /dev/null
+    wait_for_slurmctld
+    wait_for_nodes
+}
+
+wait_for_slurmctld() {
+    until ctld scontrol ping 2> /dev/null | grep -q "UP"
+    do
+        sleep 1
+    done
+}
+
+# Wait until no node is in a down/not-responding/unknown state.
+wait_for_nodes() {
+    until [ -z "$(ctld sinfo -h -N -t down,no_respond,unknown -o %N 2> /dev/null)" ]
+    do
+        sleep 1
+    done
+}
+
+# Slurm node names.
+compute_nodes() {
+    ctld sinfo -h -N -o %N | sort -u
+}
+
+# Names of the running compute containers (labelled with the compute role).
+# They run one slurmd named after the container, or several emulated nodes
+# with a generated topology.  Containers created before the label was added
+# are found by node name.
+compute_containers() {
+    local names
+    names=$(docker ps --filter label=org.slurm-docker-cluster.role=compute \
+        --format '{{.Names}}' | sort -V)
+    if [ -n "$names" ]
+    then
+        echo "$names"
+    else
+        compute_nodes
+    fi
+}
+
+# Submit a batch job and print its job ID.  Arguments are passed to sbatch.
+submit() {
+    ctld sbatch --parsable "$@" | cut -d';' -f1
+}
+
+# Block until none of the given job IDs (comma separated) is still queued or
+# running.
+wait_for_jobs() {
+    while [ -n "$(ctld squeue -h -j "$1" -o %i 2> /dev/null)" ]
+    do
+        sleep 1
+    done
+}
+
+# Block until the queue is empty.
+wait_for_empty_queue() {
+    while [ -n "$(ctld squeue -h -o %i 2> /dev/null | head -1)" ]
+    do
+        sleep 1
+    done
+}
+
+# Block until slurmctld has no accounting messages queued for slurmdbd.
+wait_for_dbd_agent() {
+    until ctld sdiag 2> /dev/null | grep -Eq "DBD Agent queue size: +0$"
+    do
+        sleep 1
+    done
+}
+
+# Reset the slurmdbd RPC statistics (see dbd_stats.py).
+dbd_stats_clear() {
+    ctld sacctmgr -i clear stats > /dev/null
+}
+
+# Print the slurmdbd RPC statistics as JSON labelled with $1.
+dbd_stats() {
+    ctld sacctmgr show stats | python3 "${BENCH_DIR}/dbd_stats.py" --json --label "$1"
+}
+
+# Register the cluster with slurmdbd unless it already is, as
+# register_cluster.sh does.
+ensure_cluster_registered() {
+    until ctld sacctmgr -n show cluster format=cluster > /dev/null 2>&1
+    do
+        sleep 2
+    done
+    if ! ctld sacctmgr -n show cluster format=cluster | grep -qw "$CLUSTER"
+    then
+        ctld sacctmgr --immediate add cluster name="$CLUSTER" > /dev/null
+        compose restart slurmdbd slurmctld > /dev/null
+        wait_for_slurmctld
+        wait_for_nodes
+    fi
+}
+
+# Recreate mysql as the durable database on the var_lib_mysql volume or as
+# the non-durable tmpfs database of the ephemeral-db profile, then reconnect
+# slurmdbd.  A fresh ephemeral database starts empty and is registered
+# again.
+db_mode_switch() {
+    case "$1" in
+        durable) compose up -d mysql > /dev/null ;;
+        ephemeral) compose --profile ephemeral-db up -d mysql > /dev/null ;;
+        *) die "unknown database mode: $1" ;;
+    esac
+    wait_for_mysql
+    compose restart slurmdbd > /dev/null
+    ensure_cluster_registered
+}
+
+# Print the mode of the running accounting database.
+db_mode() {
+    if [ "$(docker inspect -f '{{ index .Config.Labels "org.slurm-docker-cluster.durability" }}' mysql 2> /dev/null)" = "none" ]
+    then
+        echo ephemeral
+    else
+        echo durable
+    fi
+}
+
+# Reset the slurmctld statistics reported by sdiag.
+sdiag_reset() {
+    ctld sdiag -r > /dev/null
+}
+
+# Print the sdiag statistics as JSON labelled with $1 (see sdiag.py).
+sdiag_json() {
+    ctld sdiag | python3 "${BENCH_DIR}/sdiag.py" --label "$1"
+}
+
+# Run a file of commands (typically sbatch lines) on the controller in one
+# shell, which is much faster than one `docker exec` per job.
+submit_script() {
+    ctld bash -s < "$1"
+}
+
+# Total number of CPUs in the cluster.
+total_cpus() {
+    ctld sinfo -h -o %C | awk -F/ '{ s += $4 } END { print s }'
+}
+
+# Start rpc_probe.py on the controller in the background, running the given
+# command (default: squeue of one job) every PROBE_INTERVAL ms.  Samples go
+# to the file $1; stop with probe_stop.
+probe_start() {
+    local file=$1
+    shift
+    [ $# -gt 0 ] || set -- squeue -h -j 1
+    ctld rm -f /tmp/probe.stop
+    docker exec -i "$CONTROLLER" python3 - /tmp/probe.stop "${PROBE_INTERVAL:-100}" "$@" \
+        < "${BENCH_DIR}/rpc_probe.py" > "$file" &
+    PROBE_PID=$!
+}
+
+probe_stop() {
+    ctld touch /tmp/probe.stop
+    wait "$PROBE_PID" 2> /dev/null || true
+}
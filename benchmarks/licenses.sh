@@ -0,0 +1,90 @@
+#!/bin/bash
+#
+# License-constrained scheduling benchmark.
+#
+# Runs the same workload twice: once with every job unconstrained and once
+# with a fraction of the jobs requesting local (matlab, fluent) or remote
+# (ansys@flexlm) licenses.  The license jobs are submitted first so that
+# license-blocked jobs sit at the top of the queue.  Reported per run: main
+# and backfill scheduler cycle times and, per job class, wait time, bounded
+# slowdown, makespan and utilization.
+#
+#     ./benchmarks/licenses.sh [-n JOBS] [-f LICENSED_FRACTION] [-t MAX_RUNTIME]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=300
+FRACTION=0.4
+MAX_RUNTIME=60
+
+while getopts "n:f:t:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        f) FRACTION=$OPTARG ;;
+        t) MAX_RUNTIME=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-f FRACTION] [-t MAX_RUNTIME]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir licenses)
+trap 'slurm_conf_reset; slurm_restart' EXIT
+
+"${ROOT_DIR}/profiles/licenses/setup.sh" > "${OUT}/licenses.txt"
+CPUS=$(total_cpus)
+
+# Print the sbatch lines of the workload; $1 = yes to request licenses.
+workload() {
+    python3 - "$JOBS" "$FRACTION" "$MAX_RUNTIME" "$1" <<'PY'
+import random, sys
+jobs, fraction, max_runtime, licensed = int(sys.argv[1]), float(sys.argv[2]), int(sys.argv[3]), sys.argv[4] == "yes"
+rng = random.Random(42)
+licenses = ["matlab:1", "matlab:2", "fluent:1", "ansys@flexlm:2", "ansys@flexlm:4"]
+lines = []
+for i in range(jobs):
+    runtime = rng.randint(max(1, max_runtime // 6), max_runtime)
+    limit = max(1, (runtime * 2 + 59) // 60)
+    lic = rng.random() < fraction
+    opts = "--job-name=%s --time=%d --output=/dev/null" % ("lic" if lic else "free", limit)
+    if lic and licensed:
+        opts += " --licenses=" + rng.choice(licenses)
+    lines.append((0 if lic else 1, i, "sbatch %s --wrap='sleep %d' > /dev/null" % (opts, runtime)))
+for _, _, line in sorted(lines):
+    print(line)
+PY
+}
+
+for run in unconstrained licensed
+do
+    log "Run ${run}: ${JOBS} jobs ..."
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+    workload "$([ "$run" = licensed ] && echo yes || echo no)" > "${OUT}/${run}.jobs"
+    sdiag_reset
+    start=$(date -u +%Y-%m-%dT%H:%M:%S)
+    submit_script "${OUT}/${run}.jobs"
+    wait_for_empty_queue
+    sdiag_json "$run" >> "${OUT}/sdiag.json"
+    ctld sacct -a -n -P -X -S "$start" -o JobID,JobName,Submit,Start,End,AllocCPUS,State \
+        > "${OUT}/${run}.sacct"
+done
+
+{
+    python3 - "$OUT" <<'PY'
+import json, os, sys
+print("%-14s %14s %14s %14s %14s" % ("run", "main cycle us", "bf cycle us", "bf max us", "bf depth"))
+for line in open(os.path.join(sys.argv[1], "sdiag.json")):
+    s = json.loads(line)
+    print("%-14s %14.0f %14.0f %14.0f %14.0f" % (s["label"], s.get("main.mean_cycle", 0),
+          s.get("backfill.mean_cycle", 0), s.get("backfill.max_cycle", 0),
+          s.get("backfill.mean_depth_cycle", s.get("backfill.last_depth_cycle", 0))))
+PY
+    for run in unconstrained licensed
+    do
+        echo
+        echo "=== ${run} (wait in seconds)"
+        python3 "${BENCH_DIR}/workload_stats.py" --cpus "$CPUS" --record "$OUT" --label "$run" \
+            "${OUT}/${run}.sacct"
+    done
+} | tee "${OUT}/summary.txt"
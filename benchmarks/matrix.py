@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Side-by-side table of the runs of matrix.sh.
+
+    benchmarks/matrix.py OUT_DIR VERSION...
+
+OUT_DIR/VERSION/ holds the run directories of one version.  For every
+benchmark metric the table shows the median per version and its change
+against the first version; "*" marks a change that is significant
+(Mann-Whitney U, p < 0.05) and "!" one that is also worse by more than 5%.
+"""
+
+import argparse
+import os
+import sys
+from collections import OrderedDict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from report import MIN_SAMPLES, load_run, mann_whitney, pool  # noqa: E402
+from stats import percentile  # noqa: E402
+
+ALPHA = 0.05
+THRESHOLD = 5.0
+
+
+def load_version(path):
+    """{benchmark: pooled metrics} of the runs under path."""
+    runs = OrderedDict()
+    if os.path.isdir(path):
+        for name in sorted(os.listdir(path)):
+            run_dir = os.path.join(path, name)
+            if os.path.exists(os.path.join(run_dir, "run.json")):
+                meta, metrics = load_run(run_dir)
+                runs.setdefault(meta["benchmark"], []).append((meta, metrics))
+    return OrderedDict((benchmark, pool(r)) for benchmark, r in runs.items())
+
+
+def cell(base, metric):
+    if metric is None or not metric["values"]:
+        return "-"
+    median = percentile(sorted(metric["values"]), 50)
+    if base is None or base is metric or not base["values"]:
+        return "%.4g" % median
+    b = percentile(sorted(base["values"]), 50)
+    change = 100.0 * (median - b) / abs(b) if b else 0.0
+    mark = ""
+    if min(len(base["values"]), len(metric["values"])) >= MIN_SAMPLES \
+            and mann_whitney(base["values"], metric["values"]) < ALPHA:
+        worse = change > THRESHOLD if metric["better"] == "lower" else change < -THRESHOLD
+        mark = "!" if worse else "*"
+    return "%.4g (%+.0f%%)%s" % (median, change, mark)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dir")
+    parser.add_argument("versions", nargs="+")
+    args = parser.parse_args()
+
+    results = OrderedDict((v, load_version(os.path.join(args.dir, v))) for v in args.versions)
+    first = results[args.versions[0]]
+    rows = []
+    benchmarks = OrderedDict()
+    for version in results.values():
+        for benchmark, metrics in version.items():
+            names = benchmarks.setdefault(benchmark, OrderedDict())
+            for name, metric in metrics.items():
+                names.setdefault(name, metric["unit"])
+    for benchmark, names in benchmarks.items():
+        for name, unit in names.items():
+            base = first.get(benchmark, {}).get(name)
+            label = "%s %s%s" % (benchmark, name, " [%s]" % unit if unit else "")
+            rows.append([label] + [cell(base, results[v].get(benchmark, {}).get(name))
+                                   for v in args.versions])
+
+    header = ["metric"] + args.versions
+    widths = [max(len(r[i]) for r in rows + [header]) for i in range(len(header))]
+    print("  ".join(h.ljust(w) if i == 0 else h.rjust(w)
+                    for i, (h, w) in enumerate(zip(header, widths))))
+    for r in rows:
+        print("  ".join(c.ljust(w) if i == 0 else c.rjust(w)
+                        for i, (c, w) in enumerate(zip(r, widths))))
+    print("(median; change against %s; * significant, ! significantly worse by more than %.0f%%)"
+          % (args.versions[0], THRESHOLD))
+
+
+if __name__ == "__main__":
+    main()
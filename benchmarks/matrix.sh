@@ -0,0 +1,78 @@
+#!/bin/bash
+#
+# Cross-version performance matrix: build an image for every Slurm tag, bring
+# up the same cluster on each, run the same benchmark suite and print the
+# results side by side (matrix.py).
+#
+# Each version runs as its own compose project (slurm-matrix-<version>) with
+# fresh volumes, which are removed afterwards, and its own image
+# (slurm-docker-cluster:matrix-<tag>).  The image and volumes of the normal
+# cluster are not touched, but its containers must be removed first
+# (`docker-compose down`) because the container names are the same.
+#
+# The suite is one benchmark command line per line, relative to benchmarks/
+# (default: SUITE below).  PROFILES applies to every version.
+#
+#     ./benchmarks/matrix.sh -t "slurm-19-05-1-2 slurm-19-05-8-1" [-f SUITE_FILE]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+TAGS=""
+SUITE="job_lifecycle.sh -n 200
+bulk_ops.sh -n 5000 -q 200
+licenses.sh -n 500"
+
+while getopts "t:f:" opt
+do
+    case "$opt" in
+        t) TAGS=$OPTARG ;;
+        f) SUITE=$(grep -v '^ *#' "$OPTARG") ;;
+        *) echo "usage: $0 -t SLURM_TAGS [-f SUITE_FILE]" >&2; exit 2 ;;
+    esac
+done
+[ -n "$TAGS" ] || die "no Slurm tags given (-t)"
+
+require_project "slurm-matrix-*"
+
+OUT=$(output_dir matrix)
+VERSIONS=()
+
+# slurm-19-05-2-1 -> 19.05.2, the version label of the results.
+version_label() {
+    echo "$1" | sed -E 's/^slurm-([0-9]+)-([0-9]+)-([0-9]+).*/\1.\2.\3/'
+}
+
+for tag in $TAGS
+do
+    version=$(version_label "$tag")
+    VERSIONS+=("$version")
+    export IMAGE_TAG="matrix-${tag}"
+    export COMPOSE_PROJECT_NAME="slurm-matrix-${version//./-}"
+
+    log "Building slurm-docker-cluster:${IMAGE_TAG} from ${tag} ..."
+    docker build --build-arg SLURM_TAG="$tag" -t "slurm-docker-cluster:${IMAGE_TAG}" "$ROOT_DIR" \
+        > "${OUT}/build-${version}.log" 2>&1 || die "build of ${tag} failed, see ${OUT}/build-${version}.log"
+
+    log "Starting the ${version} cluster ..."
+    compose up -d > /dev/null
+    wait_for_mysql
+    ensure_cluster_registered
+    wait_for_slurmctld
+    wait_for_nodes
+
+    while read -r benchmark args <&3
+    do
+        [ -n "$benchmark" ] || continue
+        log "${version}: ${benchmark} ${args} ..."
+        # Word splitting of the arguments is intended.
+        RESULTS_DIR="${OUT}/${version}" "${BENCH_DIR}/${benchmark}" $args \
+            > "${OUT}/${version}-${benchmark%.sh}.log" 2>&1 \
+            || info "${benchmark} failed on ${version}, see ${OUT}/${version}-${benchmark%.sh}.log"
+    done 3<<< "$SUITE"
+
+    log "Removing the ${version} cluster ..."
+    compose down -v > /dev/null
+done
+
+python3 "${BENCH_DIR}/matrix.py" "$OUT" "${VERSIONS[@]}" | tee "${OUT}/summary.txt"
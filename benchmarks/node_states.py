@@ -0,0 +1,62 @@
+"""Sample the state of every node until a stop file appears.
+
+Run inside the controller container (python3.4 from the image):
+
+    python3 - STOPFILE INTERVAL_MS < node_states.py
+
+Prints one line per node and sample:
+
+    <epoch ms> <node> <state> <cpus allocated> <cpus total> <boot epoch>
+
+where state is the State= field of `scontrol show node`, e.g. IDLE,
+MIXED+DRAIN+REBOOT or DOWN*+REBOOT.
+"""
+
+import os
+import re
+import subprocess
+import sys
+import time
+
+FIELD = re.compile(r"(\w+)=(\S*)")
+
+
+def boot_epoch(text):
+    try:
+        return int(time.mktime(time.strptime(text, "%Y-%m-%dT%H:%M:%S")))
+    except ValueError:
+        return 0
+
+
+def sample():
+    output = subprocess.check_output(["scontrol", "-o", "show", "node"]).decode()
+    now = time.time() * 1000
+    for line in output.splitlines():
+        fields = dict(FIELD.findall(line))
+        if "NodeName" not in fields:
+            continue
+        sys.stdout.write("%d %s %s %s %s %d\n" % (
+            now, fields["NodeName"], fields.get("State", "UNKNOWN"),
+            fields.get("CPUAlloc", "0"), fields.get("CPUTot", "0"),
+            boot_epoch(fields.get("BootTime", ""))))
+    sys.stdout.flush()
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    stopfile, interval = sys.argv[1], float(sys.argv[2]) / 1000.0
+    while not os.path.exists(stopfile):
+        start = time.time()
+        try:
+            sample()
+        except subprocess.CalledProcessError:
+            pass
+        elapsed = time.time() - start
+        if elapsed < interval:
+            time.sleep(interval - elapsed)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,87 @@
+"""Job output file I/O in a flat versus a sharded directory layout.
+
+Runs inside a compute container (python3.4 from the image) on the shared
+/data volume:
+
+    populate ROOT LAYOUT COUNT    create COUNT slurm-<n>.out files
+    measure ROOT LAYOUT SAMPLES   time the file operations of job completion
+
+The measured operations are the ones slurmstepd and users perform on a job
+output file: create/append/close, stat and listing the containing directory.
+The sharded layout matches bin/sbatch: a random one of two levels of 256
+directories per file.
+Latencies are printed one per line as "<operation> <microseconds>".
+"""
+
+import os
+import sys
+import time
+
+PAYLOAD = b"x" * 1024
+
+
+def path_for(root, layout, n):
+    name = "slurm-%d.out" % n
+    if layout == "flat":
+        return os.path.join(root, name)
+    shard = os.urandom(2)
+    return os.path.join(root, "%02x" % shard[0], "%02x" % shard[1], name)
+
+
+def populate(root, layout, count):
+    made = set()
+    for n in range(count):
+        path = path_for(root, layout, n)
+        parent = os.path.dirname(path)
+        if parent not in made:
+            if not os.path.isdir(parent):
+                os.makedirs(parent)
+            made.add(parent)
+        os.close(os.open(path, os.O_CREAT | os.O_WRONLY, 0o644))
+        if n and n % 100000 == 0:
+            sys.stderr.write("-- %d files\n" % n)
+
+
+def timed(op, fn):
+    start = time.time()
+    result = fn()
+    sys.stdout.write("%s %.1f\n" % (op, (time.time() - start) * 1e6))
+    return result
+
+
+def measure(root, layout, samples):
+    # New job IDs after the populated range, as new jobs would get.
+    base = 10 ** 9
+    for i in range(samples):
+        path = path_for(root, layout, base + i)
+        parent = os.path.dirname(path)
+        if not os.path.isdir(parent):
+            os.makedirs(parent)
+
+        def complete():
+            fd = os.open(path, os.O_CREAT | os.O_WRONLY | os.O_APPEND, 0o644)
+            os.write(fd, PAYLOAD)
+            os.fsync(fd)
+            os.close(fd)
+
+        timed("create_write_close", complete)
+        timed("stat", lambda: os.stat(path))
+        timed("listdir", lambda: os.listdir(parent))
+        timed("unlink", lambda: os.unlink(path))
+
+
+def main():
+    if len(sys.argv) != 5 or sys.argv[1] not in ("populate", "measure"):
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    action, root, layout, count = sys.argv[1], sys.argv[2], sys.argv[3], int(sys.argv[4])
+    if layout not in ("flat", "sharded"):
+        sys.exit("layout must be flat or sharded")
+    if action == "populate":
+        populate(root, layout, count)
+    else:
+        measure(root, layout, count)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,66 @@
+#!/bin/bash
+#
+# Job-completion I/O latency with a flat versus a sharded output directory.
+#
+# Populates /data/bench-output/{flat,sharded} on the shared slurm_jobdir
+# volume with FILES output files each, then times the output file operations
+# of job completion from every compute node.  Populated trees are reused by
+# later runs with the same FILES; pass -c to remove them afterwards.
+#
+#     ./benchmarks/output_io.sh [-n FILES] [-s SAMPLES] [-c]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+FILES=1000000
+SAMPLES=100
+CLEANUP=no
+BASE=/data/bench-output
+
+while getopts "n:s:c" opt
+do
+    case "$opt" in
+        n) FILES=$OPTARG ;;
+        s) SAMPLES=$OPTARG ;;
+        c) CLEANUP=yes ;;
+        *) echo "usage: $0 [-n FILES] [-s SAMPLES] [-c]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir output_io)
+NODES=$(compute_containers)
+FIRST=$(echo "$NODES" | head -1)
+
+for layout in flat sharded
+do
+    root="${BASE}/${layout}"
+    if [ "$(docker exec "$FIRST" cat "${root}/.populated" 2> /dev/null)" != "$FILES" ]
+    then
+        log "Populating ${root} with ${FILES} files ..."
+        docker exec "$FIRST" rm -rf "$root"
+        docker exec -i "$FIRST" python3 - populate "$root" "$layout" "$FILES" \
+            < "${BENCH_DIR}/output_io.py"
+        docker exec "$FIRST" bash -c "echo ${FILES} > ${root}/.populated"
+    fi
+
+    for node in $NODES
+    do
+        log "Measuring ${layout} from ${node} ..."
+        docker exec -i "$node" python3 - measure "$root" "$layout" "$SAMPLES" \
+            < "${BENCH_DIR}/output_io.py" >> "${OUT}/${layout}.txt"
+    done
+done
+
+if [ "$CLEANUP" = "yes" ]
+then
+    log "Removing ${BASE} ..."
+    docker exec "$FIRST" rm -rf "$BASE"
+fi
+
+{
+    echo "${FILES} existing files, latencies in us"
+    for layout in flat sharded
+    do
+        awk -v layout="$layout" '{ print $1 "/" layout, $2 }' "${OUT}/${layout}.txt"
+    done | sort -s -k1,1 | python3 "${BENCH_DIR}/stats.py" --by-key --unit us --record "$OUT"
+} | tee "${OUT}/summary.txt"
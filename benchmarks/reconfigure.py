@@ -0,0 +1,48 @@
+"""Time one `scontrol reconfigure` until every slurmd has re-registered.
+
+Run inside the controller container (python3.4 from the image):
+
+    python3 - NODES TIMEOUT < reconfigure.py
+
+The RPC returns once slurmctld has re-read slurm.conf; the slurmd daemons
+are then told to reconfigure and each one re-reads the file and registers
+again.  Registrations are counted in the sdiag RPC statistics.  Prints
+"<start epoch ms> <reparse ms> <converged ms> <registrations>"; converged
+is -1 if not all NODES registered within TIMEOUT seconds.
+"""
+
+import re
+import subprocess
+import sys
+import time
+
+REGISTRATION = re.compile(r"^\s+MESSAGE_NODE_REGISTRATION_STATUS\s+\(\s*\d+\)\s+count:(\d+)", re.M)
+
+
+def registrations():
+    match = REGISTRATION.search(subprocess.check_output(["sdiag"]).decode())
+    return int(match.group(1)) if match else 0
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    nodes, timeout = int(sys.argv[1]), float(sys.argv[2])
+    base = registrations()
+    start = time.time()
+    subprocess.check_call(["scontrol", "reconfigure"])
+    reparsed = time.time()
+    converged = -1.0
+    count = 0
+    while time.time() - start < timeout:
+        count = registrations() - base
+        if count >= nodes:
+            converged = (time.time() - start) * 1000
+            break
+        time.sleep(0.1)
+    print("%d %.1f %.1f %d" % (start * 1000, (reparsed - start) * 1000, converged, count))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+#!/bin/bash
+#
+# `scontrol reconfigure` latency at increasing cluster sizes.
+#
+# For every size a topology is generated with generate_topology.py and
+# started.  Sizes above the container count emulate several nodes per
+# container, which needs an image built with
+#
+#     docker build --build-arg SLURM_CONFIGURE_EXTRA=--enable-multiple-slurmd ...
+#
+# Each repeat measures, with reconfigure.py on the controller:
+#   reparse    the reconfigure RPC itself: slurmctld re-reading slurm.conf
+#   converge   until every slurmd has re-read it and registered again
+# and, from sdiag and rpc_probe.py, how long the scheduler and other clients
+# were held up meanwhile.
+#
+#     ./benchmarks/reconfigure.sh [-s "2 500 5000"] [-c CONTAINERS] [-n REPEATS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+SIZES="2 500 5000"
+CONTAINERS=20
+REPEATS=10
+TIMEOUT=600
+PROBE_INTERVAL=50
+
+while getopts "s:c:n:" opt
+do
+    case "$opt" in
+        s) SIZES=$OPTARG ;;
+        c) CONTAINERS=$OPTARG ;;
+        n) REPEATS=$OPTARG ;;
+        *) echo "usage: $0 [-s SIZES] [-c CONTAINERS] [-n REPEATS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir reconfigure)
+trap 'probe_stop 2> /dev/null; compose up -d --remove-orphans > /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+for size in $SIZES
+do
+    containers=$(( size < CONTAINERS ? size : CONTAINERS ))
+    log "Starting ${size} nodes in ${containers} containers ..."
+    "${ROOT_DIR}/generate_topology.py" --nodes "$size" --containers "$containers"
+    slurm_conf_apply topology
+    compose --profile topology up -d --remove-orphans > /dev/null
+    slurm_restart
+    [ "$(compute_nodes | wc -l)" -eq "$size" ] || die "expected ${size} nodes, found $(compute_nodes | wc -l)"
+
+    probe_start "${OUT}/probe-${size}.txt" squeue -h -j 1
+    for i in $(seq "$REPEATS")
+    do
+        sdiag_reset
+        read -r start reparse converge count < <(
+            ctld python3 - "$size" "$TIMEOUT" < "${BENCH_DIR}/reconfigure.py")
+        [ "$converge" != "-1.0" ] || info "only ${count} of ${size} nodes registered within ${TIMEOUT}s"
+        echo "${size} ${start} ${reparse} ${converge}" >> "${OUT}/reconfigure.txt"
+        sdiag_json "$size" >> "${OUT}/sdiag.json"
+        info "${size} nodes: reparse ${reparse} ms, converged ${converge} ms"
+        wait_for_nodes
+        sleep 2
+    done
+    probe_stop
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out = sys.argv[1]
+rows = OrderedDict()
+def add(key, value):
+    rows.setdefault(key, []).append(value)
+runs = [line.split() for line in open(os.path.join(out, "reconfigure.txt"))]
+sdiag = [json.loads(line) for line in open(os.path.join(out, "sdiag.json"))]
+for (size, start, reparse, converge), s in zip(runs, sdiag):
+    add("%s/reparse_ms" % size, float(reparse))
+    if float(converge) >= 0:
+        add("%s/converge_ms" % size, float(converge))
+    add("%s/main_max_cycle_ms" % size, s.get("main.max_cycle", 0) / 1000.0)
+    # Worst probe overlapping this reconfigure and its convergence.
+    end = float(start) + max(float(converge), float(reparse))
+    probe = [tuple(float(v) for v in l.split()) for l in open(os.path.join(out, "probe-%s.txt" % size))]
+    window = [lat for t, lat in probe if t <= end and t + lat >= float(start)]
+    add("%s/probe_max_ms" % size, max(window) if window else 0.0)
+print(format_table(OrderedDict((k, summarize(v)) for k, v in rows.items())))
+for k, v in rows.items():
+    record(out, k, v, "ms")
+PY
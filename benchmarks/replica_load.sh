@@ -0,0 +1,110 @@
+#!/bin/bash
+#
+# slurmdbd commit latency under concurrent analyst query load, with the
+# analysts querying slurmdbd (sacct) or the read replica (sacct-replica).
+#
+# Requires the replica profile to be up and replicating, and a seeded
+# accounting database so that the analyst queries are realistic:
+#
+#     PROFILES=replica ./benchmarks/seed_accounting.sh -n 1000000
+#     PROFILES=replica ./benchmarks/replica_load.sh [-c ANALYSTS] [-n JOBS] [-d DAYS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+ANALYSTS=4
+JOBS=500
+DAYS=30
+FORMAT=JobID,User,Account,Partition,State,Elapsed,AllocTRES
+
+while getopts "c:n:d:" opt
+do
+    case "$opt" in
+        c) ANALYSTS=$OPTARG ;;
+        n) JOBS=$OPTARG ;;
+        d) DAYS=$OPTARG ;;
+        *) echo "usage: $0 [-c ANALYSTS] [-n JOBS] [-d DAYS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir replica_load)
+SINCE=$(date -u -d "-${DAYS} days" +%Y-%m-%d)
+
+docker inspect sacct-replica > /dev/null 2>&1 || die "sacct-replica is not running; start the replica profile"
+
+# Analyst loop: run the history query until stopped, one latency (ms) per line.
+analyst() {
+    local start
+    while :
+    do
+        start=$(now_ms)
+        case "$1" in
+            primary) ctld sacct -a -X -S "$SINCE" -E now -o "$FORMAT" -P -n > /dev/null ;;
+            replica) docker exec sacct-replica sacct-replica -a -S "$SINCE" -E now -o "$FORMAT" -P -n > /dev/null ;;
+        esac
+        echo $(( $(now_ms) - start ))
+    done
+}
+
+for mode in idle primary replica
+do
+    log "Mode ${mode}: ${ANALYSTS} analysts, ${JOBS} jobs ..."
+    pids=()
+    if [ "$mode" != "idle" ]
+    then
+        for i in $(seq "$ANALYSTS")
+        do
+            analyst "$mode" >> "${OUT}/query-${mode}.txt" 2> /dev/null &
+            pids+=($!)
+        done
+        sleep 5
+    fi
+
+    wait_for_dbd_agent
+    dbd_stats_clear
+    start=$(now_ms)
+    for i in $(seq "$JOBS")
+    do
+        submit --output=/dev/null --wrap=true > /dev/null
+    done
+    wait_for_empty_queue
+    wait_for_dbd_agent
+    elapsed=$(( $(now_ms) - start ))
+    dbd_stats "$mode" >> "${OUT}/dbd.json"
+
+    if [ ${#pids[@]} -gt 0 ]
+    then
+        kill "${pids[@]}" 2> /dev/null || true
+        wait "${pids[@]}" 2> /dev/null || true
+    fi
+    echo "${mode} ${elapsed}" >> "${OUT}/elapsed.txt"
+done
+
+if docker inspect mysql-replica > /dev/null 2>&1
+then
+    docker exec mysql-replica mysql -uroot -p"$(mysql_root_password mysql-replica)" \
+        -e "SHOW SLAVE STATUS\G" 2> /dev/null | grep Seconds_Behind_Master > "${OUT}/replica_lag.txt" || true
+fi
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import json, os, sys
+sys.path.insert(0, sys.argv[2])
+from stats import record
+out = sys.argv[1]
+elapsed = dict(line.split() for line in open(os.path.join(out, "elapsed.txt")))
+print("%-8s %12s %12s %14s %14s" % ("mode", "commits", "commit us", "jobs done ms", "query p50 ms"))
+for line in open(os.path.join(out, "dbd.json")):
+    run = json.loads(line)
+    mode = run["label"]
+    queries = os.path.join(out, "query-%s.txt" % mode)
+    p50 = "-"
+    if os.path.exists(queries):
+        values = sorted(float(v) for v in open(queries) if v.strip())
+        if values:
+            p50 = "%.0f" % values[len(values) // 2]
+            record(out, "%s/query_ms" % mode, values, "ms")
+    print("%-8s %12d %12.0f %14s %14s" % (mode, run["commit"]["count"],
+                                           run["commit"]["ave_us"], elapsed[mode], p50))
+    record(out, "%s/commit_us" % mode, [run["commit"]["ave_us"]], "us")
+    record(out, "%s/jobs_done_ms" % mode, [float(elapsed[mode])], "ms")
+PY
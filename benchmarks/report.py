@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""Compare benchmark runs and flag significant regressions.
+
+Every run directory holds run.json (what the run depended on, written by
+output_dir in lib.sh) and metrics.jsonl (samples, written by stats.record).
+Given run directories of one or more benchmarks, the newest run of each
+benchmark is compared with the runs before it:
+
+    benchmarks/report.py results/*
+
+or an explicit baseline with a candidate, samples of several runs pooled:
+
+    benchmarks/report.py --baseline results/gateway-2019* --candidate results/gateway-2020*
+
+For every metric the medians are compared and a two-sided Mann-Whitney U
+test decides whether the difference is significant.  A metric regresses
+when the difference is significant at --alpha and its median got worse by
+more than --threshold percent.  Metrics with fewer than MIN_SAMPLES samples
+on either side cannot be tested; a large change is then marked "check".
+Exits with 1 if anything regressed.
+"""
+
+import argparse
+import json
+import math
+import os
+import sys
+from collections import OrderedDict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from stats import percentile  # noqa: E402
+
+MIN_SAMPLES = 3
+# run.json fields shown when they differ between baseline and candidate.
+CONTEXT = (("slurm_tag", "slurm_tag"), ("slurm_version", "slurm_version"),
+           ("configure_extra", "build.configure_extra"), ("target", "build.target"),
+           ("image_id", "build.image_id"),
+           ("slurm.conf", "slurm_conf_sha256"), ("profiles", "profiles"),
+           ("host", "host"), ("commit", "repo_commit"))
+
+
+def load_run(path):
+    """Return (metadata, {metric: {"unit", "better", "values"}}) of a run."""
+    with open(os.path.join(path, "run.json")) as f:
+        meta = json.load(f)
+    meta["dir"] = path
+    metrics = OrderedDict()
+    metrics_file = os.path.join(path, "metrics.jsonl")
+    if os.path.exists(metrics_file):
+        with open(metrics_file) as f:
+            for line in f:
+                m = json.loads(line)
+                entry = metrics.setdefault(m["metric"], {"unit": m["unit"], "better": m["better"],
+                                                         "values": []})
+                entry["values"].extend(m["values"])
+    return meta, metrics
+
+
+def pool(runs):
+    pooled = OrderedDict()
+    for meta, metrics in runs:
+        for name, m in metrics.items():
+            entry = pooled.setdefault(name, {"unit": m["unit"], "better": m["better"], "values": []})
+            entry["values"].extend(m["values"])
+    return pooled
+
+
+def mann_whitney(a, b):
+    """Two-sided p-value of the Mann-Whitney U test (normal approximation
+    with tie correction)."""
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    n1, n2, n = len(a), len(b), len(a) + len(b)
+    ranks = [0.0] * n
+    ties = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    r1 = sum(r for r, (v, group) in zip(ranks, values) if group == 0)
+    u = r1 - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    var = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)))
+    if var <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(var)
+    return min(1.0, math.erfc(max(z, 0) / math.sqrt(2)))
+
+
+def compare(baseline, candidate, alpha, threshold):
+    """Yield one result row per metric present in both."""
+    for name, cand in candidate.items():
+        base = baseline.get(name)
+        if not base or not base["values"] or not cand["values"]:
+            continue
+        b = percentile(sorted(base["values"]), 50)
+        c = percentile(sorted(cand["values"]), 50)
+        change = 100.0 * (c - b) / abs(b) if b else 0.0
+        worse = change > threshold if cand["better"] == "lower" else change < -threshold
+        better = change < -threshold if cand["better"] == "lower" else change > threshold
+        if min(len(base["values"]), len(cand["values"])) < MIN_SAMPLES:
+            p = None
+            status = "check" if worse else "n/a"
+        else:
+            p = mann_whitney(base["values"], cand["values"])
+            if p < alpha and worse:
+                status = "REGRESSION"
+            elif p < alpha and better:
+                status = "improved"
+            else:
+                status = "ok"
+        yield OrderedDict([("metric", name), ("unit", cand["unit"]), ("better", cand["better"]),
+                           ("baseline", b), ("candidate", c), ("change_pct", change),
+                           ("n", (len(base["values"]), len(cand["values"]))),
+                           ("p", p), ("status", status)])
+
+
+def field(meta, path):
+    for part in path.split("."):
+        meta = meta.get(part, {}) if isinstance(meta, dict) else {}
+    return json.dumps(meta, sort_keys=True) if isinstance(meta, (dict, list)) else str(meta)
+
+
+def print_report(benchmark, baseline_runs, candidate_runs, rows):
+    print("=== %s: %d baseline run(s) vs %s" % (
+        benchmark, len(baseline_runs),
+        ", ".join(os.path.basename(m["dir"]) for m, _ in candidate_runs)))
+    for label, path in CONTEXT:
+        base = sorted(set(field(m, path) for m, _ in baseline_runs))
+        cand = sorted(set(field(m, path) for m, _ in candidate_runs))
+        if base != cand:
+            print("  %-15s %s -> %s" % (label, " | ".join(base), " | ".join(cand)))
+    if not rows:
+        print("  (no metrics in common)")
+        return
+    width = max(len("metric"), max(len(r["metric"]) for r in rows))
+    print("  %s %12s %12s %9s %9s %8s  %s" % ("metric".ljust(width), "baseline", "candidate",
+                                            "change", "n", "p", "status"))
+    for r in rows:
+        print("  %s %12.4g %12.4g %8.1f%% %9s %8s  %s" % (
+            r["metric"].ljust(width), r["baseline"], r["candidate"], r["change_pct"],
+            "%d/%d" % r["n"], "-" if r["p"] is None else "%.3f" % r["p"], r["status"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("runs", nargs="*", help="run directories")
+    parser.add_argument("--baseline", nargs="+", default=[], metavar="RUN")
+    parser.add_argument("--candidate", nargs="+", default=[], metavar="RUN")
+    parser.add_argument("--alpha", type=float, default=0.05)
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent")
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+
+    comparisons = []
+    if args.baseline or args.candidate:
+        if not (args.baseline and args.candidate) or args.runs:
+            parser.error("give either run directories or --baseline and --candidate")
+        baseline = [load_run(d) for d in args.baseline]
+        candidate = [load_run(d) for d in args.candidate]
+        comparisons.append((candidate[0][0]["benchmark"], baseline, candidate))
+    else:
+        by_benchmark = OrderedDict()
+        for d in sorted(args.runs):
+            if os.path.exists(os.path.join(d, "run.json")):
+                run = load_run(d)
+                by_benchmark.setdefault(run[0]["benchmark"], []).append(run)
+        for benchmark, runs in by_benchmark.items():
+            runs.sort(key=lambda r: r[0]["started"])
+            if len(runs) > 1:
+                comparisons.append((benchmark, runs[:-1], runs[-1:]))
+
+    regressed = False
+    results = []
+    for benchmark, baseline, candidate in comparisons:
+        rows = list(compare(pool(baseline), pool(candidate), args.alpha, args.threshold))
+        regressed = regressed or any(r["status"] == "REGRESSION" for r in rows)
+        if args.json:
+            results.append({"benchmark": benchmark, "metrics": rows,
+                            "baseline": [m["dir"] for m, _ in baseline],
+                            "candidate": [m["dir"] for m, _ in candidate]})
+        else:
+            print_report(benchmark, baseline, candidate, rows)
+            print()
+    if args.json:
+        print(json.dumps(results, indent=2))
+    elif not comparisons:
+        print("nothing to compare: need two runs of a benchmark")
+    sys.exit(1 if regressed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/bin/bash
+#
+# Rolling reboot benchmark: `scontrol reboot ASAP nextstate=resume` of every
+# compute node, WAVE nodes at a time, on an idle cluster and under load.
+#
+# ASAP drains a node so that no new jobs start on it, reboots it once its
+# jobs have finished and resumes it when slurmd registers with a new boot
+# time.  The compute containers stand in for the reboot with
+# node-supervisor.sh, which takes NODE_BOOT_SECONDS (default 10).
+#
+# node_states.py samples all nodes every SAMPLE_INTERVAL ms.  Reported per
+# scenario: time to complete the rollout, time per node from request to back
+# in service, and the capacity lost, i.e. CPU-seconds of CPUs that were
+# neither allocated nor schedulable (draining, rebooting or down).
+#
+#     ./benchmarks/rolling_reboot.sh [-w WAVE] [-j JOBS] [-t JOB_SECONDS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+WAVE=1
+JOBS=200
+JOB_SECONDS=30
+TIMEOUT=900
+SAMPLE_INTERVAL=500
+
+while getopts "w:j:t:" opt
+do
+    case "$opt" in
+        w) WAVE=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        t) JOB_SECONDS=$OPTARG ;;
+        *) echo "usage: $0 [-w WAVE] [-j JOBS] [-t JOB_SECONDS]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir rolling_reboot)
+trap 'ctld touch /tmp/node_states.stop; ctld scancel -u root 2> /dev/null' EXIT
+
+NODES=($(compute_nodes))
+info "${#NODES[@]} nodes, waves of ${WAVE}, ${JOBS} jobs of ${JOB_SECONDS}s under load"
+
+# Exit 0 once every node in $3 (space separated) has been sampled back in
+# service with a boot time after $2 (epoch ms) in the samples file $1.
+rebooted() {
+    awk -v since="$2" -v want="$3" '
+        BEGIN { n = split(want, w, " "); for (i = 1; i <= n; i++) need[w[i]] = 1 }
+        $1 >= since && $6 * 1000 >= since && $3 ~ /^(IDLE|MIXED|ALLOCATED)$/ { done[$2] = 1 }
+        END { for (node in need) if (!(node in done)) exit 1 }' "$1"
+}
+
+for scenario in idle loaded
+do
+    ctld scancel -u root 2> /dev/null || true
+    wait_for_empty_queue
+    wait_for_nodes
+
+    if [ "$scenario" = "loaded" ]
+    then
+        log "Submitting ${JOBS} jobs ..."
+        for i in $(seq "$JOBS")
+        do
+            echo "sbatch --parsable --output=/dev/null --wrap='sleep ${JOB_SECONDS}'"
+        done > "${OUT}/load.sh"
+        submit_script "${OUT}/load.sh" > /dev/null
+        sleep 5
+    fi
+
+    log "Rolling reboot (${scenario}) ..."
+    samples="${OUT}/states-${scenario}.txt"
+    ctld rm -f /tmp/node_states.stop
+    docker exec -i "$CONTROLLER" python3 - /tmp/node_states.stop "$SAMPLE_INTERVAL" \
+        < "${BENCH_DIR}/node_states.py" > "$samples" &
+    sampler=$!
+    sleep 2
+
+    for ((i = 0; i < ${#NODES[@]}; i += WAVE))
+    do
+        wave="${NODES[*]:i:WAVE}"
+        since=$(now_ms)
+        for node in $wave
+        do
+            echo "${scenario} ${node} ${since}" >> "${OUT}/requests.txt"
+        done
+        ctld scontrol reboot ASAP nextstate=resume reason=rolling-reboot "${wave// /,}"
+        until rebooted "$samples" "$since" "$wave"
+        do
+            [ $(( $(now_ms) - since )) -lt $((TIMEOUT * 1000)) ] || die "${wave} did not come back within ${TIMEOUT}s"
+            sleep 1
+        done
+        info "${wave}: back after $(( $(now_ms) - since )) ms"
+    done
+
+    sleep 2
+    ctld touch /tmp/node_states.stop
+    wait "$sampler" || true
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out = sys.argv[1]
+UNAVAILABLE = ("DRAIN", "REBOOT", "DOWN", "*")
+
+requests = OrderedDict()
+for line in open(os.path.join(out, "requests.txt")):
+    scenario, node, since = line.split()
+    requests.setdefault(scenario, []).append((node, float(since)))
+
+rows = OrderedDict()
+for scenario, reqs in requests.items():
+    samples = OrderedDict()
+    for line in open(os.path.join(out, "states-%s.txt" % scenario)):
+        t, node, state, alloc, total, boot = line.split()
+        samples.setdefault(float(t), []).append((node, state, int(alloc), int(total), int(boot)))
+    # Per node: request until the first sample back in service after a reboot.
+    back = {}
+    for node, since in reqs:
+        for t, nodes in samples.items():
+            if t < since:
+                continue
+            s = [n for n in nodes if n[0] == node]
+            if s and s[0][4] * 1000 >= since and s[0][1] in ("IDLE", "MIXED", "ALLOCATED"):
+                back[node] = t - since
+                break
+    start = min(since for node, since in reqs)
+    end = max(since + back.get(node, 0) for node, since in reqs)
+    lost = peak = cpus = 0
+    times = [t for t in samples if start <= t <= end]
+    for t0, t1 in zip(times, times[1:]):
+        down = sum(total - alloc for node, state, alloc, total, boot in samples[t0]
+                   if any(flag in state for flag in UNAVAILABLE))
+        cpus = sum(n[3] for n in samples[t0])
+        lost += down * (t1 - t0) / 1000.0
+        peak = max(peak, down)
+    window = (end - start) / 1000.0
+    rows["%s/node_reboot_s" % scenario] = summarize([v / 1000.0 for v in back.values()])
+    record(out, "%s/node_reboot_s" % scenario, [v / 1000.0 for v in back.values()], "s")
+    record(out, "%s/rollout_s" % scenario, [window], "s")
+    record(out, "%s/lost_cpu_s" % scenario, [lost], "CPU-s")
+    print("%s: rollout %.1fs, %d of %d nodes back, %.0f CPU-s lost (%.1f%% of capacity), peak %d CPUs unavailable"
+          % (scenario, window, len(back), len(reqs), lost,
+             100.0 * lost / (cpus * window) if cpus and window else 0.0, peak))
+print(format_table(rows))
+PY
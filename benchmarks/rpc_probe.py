@@ -0,0 +1,35 @@
+"""Measure slurmctld responsiveness while something else happens.
+
+Run inside the controller container (python3.4 from the image):
+
+    python3 - STOPFILE INTERVAL_MS COMMAND... < rpc_probe.py
+
+Runs COMMAND every INTERVAL_MS until STOPFILE exists and prints one
+"<start epoch ms> <latency ms>" line per run.  A probe that takes longer
+than usual is an RPC stalled behind slurmctld locks.
+"""
+
+import os
+import subprocess
+import sys
+import time
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    stopfile, interval, command = sys.argv[1], float(sys.argv[2]) / 1000.0, sys.argv[3:]
+    devnull = open(os.devnull, "w")
+    while not os.path.exists(stopfile):
+        start = time.time()
+        subprocess.call(command, stdout=devnull, stderr=devnull)
+        elapsed = time.time() - start
+        sys.stdout.write("%d %.1f\n" % (start * 1000, elapsed * 1000))
+        sys.stdout.flush()
+        if elapsed < interval:
+            time.sleep(interval - elapsed)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Parse `sdiag` output into JSON.
+
+Main scheduler and backfill statistics become "main.<name>" and
+"backfill.<name>" keys (e.g. "main.mean_cycle", "backfill.last_cycle", in
+microseconds as sdiag reports them), the other counters at the top become
+"<name>", and the RPC tables become "rpc" and "rpc_user" objects of
+{"count", "ave_us", "total_us"}.
+
+    sdiag | benchmarks/sdiag.py [--label NAME]
+"""
+
+import argparse
+import json
+import re
+import sys
+
+RPC_LINE = re.compile(r"^\s+(\S+)\s+\(\s*\d+\)\s+count:(\d+)\s+ave_time:(\d+)\s+total_time:(\d+)")
+VALUE_LINE = re.compile(r"^\s*([^:]+):\s+(-?[\d.]+)\s*$")
+
+
+def key(text):
+    return re.sub(r"[^a-z0-9]+", "_", text.strip().lower()).strip("_")
+
+
+def parse(text):
+    result = {"rpc": {}, "rpc_user": {}}
+    section = ""
+    for line in text.splitlines():
+        if not line.strip():
+            continue
+        if not line[0].isspace():
+            header = line.lower()
+            if header.startswith("main schedule"):
+                section = "main."
+            elif header.startswith("backfilling"):
+                section = "backfill."
+            elif "by message type" in header:
+                section = "rpc"
+            elif "by user" in header:
+                section = "rpc_user"
+            else:
+                section = ""
+            # Top level counters ("Jobs submitted: 10") have no section.
+            match = VALUE_LINE.match(line)
+            if match:
+                result[key(match.group(1))] = float(match.group(2))
+            continue
+        if section in ("rpc", "rpc_user"):
+            match = RPC_LINE.match(line)
+            if match:
+                result[section][match.group(1)] = {
+                    "count": int(match.group(2)),
+                    "ave_us": int(match.group(3)),
+                    "total_us": int(match.group(4)),
+                }
+            continue
+        match = VALUE_LINE.match(line)
+        if match:
+            result[section + key(match.group(1))] = float(match.group(2))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--label", default="")
+    args = parser.parse_args()
+    result = parse(sys.stdin.read())
+    result["label"] = args.label
+    print(json.dumps(result, sort_keys=True))
+
+
+if __name__ == "__main__":
+    main()
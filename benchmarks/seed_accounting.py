@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Generate SQL that seeds slurm_acct_db with synthetic job history.
+
+Reads "<id_assoc> <user> <account>" lines (the user associations of the
+cluster) from --assocs and writes INSERT statements for JOBS jobs, each with
+a batch step, spread over the last DAYS days.  Job IDs start at --first-id so
+that they never collide with real jobs.  Pipe the output into mysql; see
+seed_accounting.sh.
+"""
+
+import argparse
+import random
+import sys
+import time
+
+BATCH = 1000
+# SLURM_BATCH_SCRIPT as stored in the step table.
+BATCH_STEP = -2
+# JOB_COMPLETED, JOB_CANCELLED, JOB_FAILED, JOB_TIMEOUT with realistic weights.
+STATES = [(3, 80), (4, 10), (5, 7), (6, 3)]
+
+
+def weighted_state(rng):
+    pick = rng.randint(1, sum(w for _, w in STATES))
+    for state, weight in STATES:
+        pick -= weight
+        if pick <= 0:
+            return state
+    return STATES[0][0]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cluster", default="linux")
+    parser.add_argument("--assocs", required=True, help="association list file")
+    parser.add_argument("--jobs", type=int, default=100000)
+    parser.add_argument("--days", type=int, default=90)
+    parser.add_argument("--first-id", type=int, default=10000000)
+    parser.add_argument("--partitions", default="normal")
+    parser.add_argument("--nodes", default="c[1-2]")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    assocs = []
+    with open(args.assocs) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 3:
+                assocs.append(fields)
+    if not assocs:
+        sys.exit("no user associations found; add users with sacctmgr first")
+
+    uids = {}
+    for _, user, _ in assocs:
+        uids.setdefault(user, 0 if user == "root" else 1000 + len(uids))
+
+    rng = random.Random(args.seed)
+    partitions = args.partitions.split(",")
+    now = int(time.time())
+    job_table = "`%s_job_table`" % args.cluster
+    step_table = "`%s_step_table`" % args.cluster
+    out = sys.stdout
+
+    # Omitted NOT NULL columns take their implicit defaults.
+    out.write("SET SESSION sql_mode = 'NO_ENGINE_SUBSTITUTION';\n")
+    for base in range(0, args.jobs, BATCH):
+        rows = []
+        for i in range(base, min(base + BATCH, args.jobs)):
+            id_assoc, user, account = rng.choice(assocs)
+            submit = now - rng.randint(0, args.days * 86400)
+            eligible = submit + rng.randint(0, 5)
+            start = eligible + int(rng.expovariate(1 / 600.0))
+            end = start + int(rng.expovariate(1 / 3600.0)) + 1
+            cpus = rng.choice([1, 1, 1, 2, 4, 8])
+            mem = cpus * 500
+            nodes = 1
+            tres = "1=%d,2=%d,4=%d" % (cpus, mem, nodes)
+            rows.append(
+                "(%d,%s,%d,0,'%s','%s','seed-%d',%d,0,%d,%d,%d,'%s',%d,%d,%d,%d,%d,"
+                "'%s','%s',1,'/data',%d)" % (
+                    args.first_id + i, id_assoc, uids[user],
+                    account, rng.choice(partitions), i % 100, weighted_state(rng),
+                    cpus, mem, nodes, args.nodes,
+                    rng.choice([60, 600, 1440]), submit, eligible, start, end,
+                    tres, tres, end))
+        out.write(
+            "BEGIN;\nINSERT INTO %s (id_job,id_assoc,id_user,id_group,account,`partition`,"
+            "job_name,state,exit_code,cpus_req,mem_req,nodes_alloc,nodelist,timelimit,"
+            "time_submit,time_eligible,time_start,time_end,tres_alloc,tres_req,id_qos,"
+            "work_dir,mod_time) VALUES\n%s;\n" % (job_table, ",\n".join(rows)))
+        out.write(
+            "INSERT INTO %s (job_db_inx,id_step,step_name,nodelist,nodes_alloc,state,"
+            "task_cnt,time_start,time_end,tres_alloc) SELECT job_db_inx,%d,'batch',"
+            "nodelist,nodes_alloc,state,1,time_start,time_end,tres_alloc FROM %s "
+            "WHERE id_job BETWEEN %d AND %d;\nCOMMIT;\n" % (
+                step_table, BATCH_STEP, job_table, args.first_id + base,
+                args.first_id + min(base + BATCH, args.jobs) - 1))
+
+
+if __name__ == "__main__":
+    main()
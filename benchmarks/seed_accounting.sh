@@ -0,0 +1,38 @@
+#!/bin/bash
+#
+# Seed slurm_acct_db with synthetic job history for the accounting
+# benchmarks.  Jobs are assigned to the existing user associations of the
+# cluster and get IDs from FIRST_ID up, so real jobs are left alone.
+#
+#     ./benchmarks/seed_accounting.sh [-n JOBS] [-d DAYS] [-f FIRST_ID]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+JOBS=1000000
+DAYS=90
+FIRST_ID=10000000
+
+while getopts "n:d:f:" opt
+do
+    case "$opt" in
+        n) JOBS=$OPTARG ;;
+        d) DAYS=$OPTARG ;;
+        f) FIRST_ID=$OPTARG ;;
+        *) echo "usage: $0 [-n JOBS] [-d DAYS] [-f FIRST_ID]" >&2; exit 2 ;;
+    esac
+done
+
+assocs=$(mktemp)
+trap 'rm -f "$assocs"' EXIT
+acct_db -e "SELECT id_assoc, user, acct FROM \`${CLUSTER}_assoc_table\` WHERE user != '' AND deleted = 0" > "$assocs"
+
+log "Removing previously seeded jobs ..."
+acct_db -e "DELETE s FROM \`${CLUSTER}_step_table\` s JOIN \`${CLUSTER}_job_table\` j USING (job_db_inx) WHERE j.id_job >= ${FIRST_ID}; DELETE FROM \`${CLUSTER}_job_table\` WHERE id_job >= ${FIRST_ID}"
+
+log "Seeding ${JOBS} jobs over ${DAYS} days ..."
+start=$(now_ms)
+python3 "${BENCH_DIR}/seed_accounting.py" --cluster "$CLUSTER" --assocs "$assocs" \
+        --jobs "$JOBS" --days "$DAYS" --first-id "$FIRST_ID" \
+    | acct_db
+info "Seeded in $(( ($(now_ms) - start) / 1000 ))s"
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Generate a sacctmgr load file with a synthetic account hierarchy.
+
+Builds DEPTH levels of accounts under root with BRANCHING children each.
+Every account carries GrpTRES/GrpJobs/GrpSubmitJobs limits, and every leaf
+account gets USERS synthetic users plus an association for root, all with
+MaxJobs/MaxSubmitJobs limits, so benchmarks can submit as root into any leaf
+with --account and have the per-user limits checked.  All names start with "bench" so the hierarchy can be removed
+again.  The limits are generous: they are meant to be evaluated, not hit.
+
+    seed_associations.py --cluster linux --depth 3 --branching 10 --users 5
+"""
+
+import argparse
+
+
+def account_line(name, level, args):
+    cpus = args.leaf_cpus * args.branching ** (args.depth - level)
+    jobs = args.leaf_jobs * args.branching ** (args.depth - level)
+    return ("Account - '%s':Description='%s':Organization='bench':Fairshare=1:"
+            "GrpTRES=cpu=%d:GrpJobs=%d:GrpSubmitJobs=%d"
+            % (name, name, cpus, jobs, jobs * 10))
+
+
+def user_line(name, account, args):
+    return ("User - '%s':DefaultAccount='%s':Fairshare=1:MaxJobs=%d:MaxSubmitJobs=%d"
+            % (name, account, args.leaf_jobs, args.leaf_jobs * 10))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cluster", default="linux")
+    parser.add_argument("--depth", type=int, default=3)
+    parser.add_argument("--branching", type=int, default=10)
+    parser.add_argument("--users", type=int, default=5)
+    parser.add_argument("--leaf-cpus", type=int, default=1000)
+    parser.add_argument("--leaf-jobs", type=int, default=1000)
+    args = parser.parse_args()
+
+    # sacctmgr load: a "Parent" line opens the children of an account.
+    lines = ["Cluster - '%s':Fairshare=1:QOS='normal'" % args.cluster,
+             "Parent - 'root'",
+             "User - 'root':DefaultAccount='root':AdminLevel='Administrator':Fairshare=1"]
+    level = ["bench"]
+    lines.append(account_line("bench", 0, args))
+    for depth in range(1, args.depth + 1):
+        children = []
+        for parent in level:
+            lines.append("Parent - '%s'" % parent)
+            for i in range(args.branching):
+                child = "%s_%d" % (parent, i)
+                lines.append(account_line(child, depth, args))
+                children.append(child)
+        level = children
+    for leaf in level:
+        lines.append("Parent - '%s'" % leaf)
+        lines.append(user_line("root", "root", args))
+        for u in range(args.users):
+            lines.append(user_line("%su%d" % (leaf, u), leaf, args))
+    print("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,70 @@
+#!/bin/bash
+#
+# Load (or with -r only remove) the synthetic "bench" account hierarchy of
+# seed_associations.py.  Prints the leaf accounts, one per line, to
+# results/associations/leaves.txt.
+#
+#     ./benchmarks/seed_associations.sh [-d DEPTH] [-b BRANCHING] [-u USERS] [-r]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+DEPTH=3
+BRANCHING=10
+USERS=5
+REMOVE_ONLY=no
+
+while getopts "d:b:u:r" opt
+do
+    case "$opt" in
+        d) DEPTH=$OPTARG ;;
+        b) BRANCHING=$OPTARG ;;
+        u) USERS=$OPTARG ;;
+        r) REMOVE_ONLY=yes ;;
+        *) echo "usage: $0 [-d DEPTH] [-b BRANCHING] [-u USERS] [-r]" >&2; exit 2 ;;
+    esac
+done
+
+# Comma-join the names on stdin, 500 per line.  sacctmgr takes a list of
+# names as one argument, which the kernel limits to 128 KiB.
+chunks() {
+    xargs -r -n 500 | tr ' ' ,
+}
+
+log "Removing the existing bench hierarchy ..."
+ctld sacctmgr -n -P show user format=user | grep '^bench' | chunks | while read -r names
+do
+    ctld sacctmgr -i delete user name="$names" < /dev/null > /dev/null
+done
+# Deepest accounts first: an account can only go once it has no children.
+accounts=$(ctld sacctmgr -n -P show account format=account | grep '^bench' \
+    | awk -F_ '{ print NF, $0 }' | sort -rn | cut -d' ' -f2)
+if [ -n "$accounts" ]
+then
+    echo "$accounts" | chunks | while read -r names
+    do
+        ctld sacctmgr -i delete user name=root account="$names" < /dev/null > /dev/null 2>&1 || true
+    done
+    for depth in $(echo "$accounts" | awk -F_ '{ print NF }' | sort -rnu)
+    do
+        echo "$accounts" | awk -F_ -v n="$depth" 'NF == n' | chunks | while read -r names
+        do
+            ctld sacctmgr -i delete account name="$names" < /dev/null > /dev/null
+        done
+    done
+fi
+
+if [ "$REMOVE_ONLY" = "yes" ]
+then
+    exit 0
+fi
+
+log "Loading a hierarchy of depth ${DEPTH}, branching ${BRANCHING}, ${USERS} users per leaf ..."
+python3 "${BENCH_DIR}/seed_associations.py" --cluster "$CLUSTER" --depth "$DEPTH" \
+        --branching "$BRANCHING" --users "$USERS" \
+    | ctld_sh "cat > /tmp/bench_assoc.cfg && sacctmgr -i load file=/tmp/bench_assoc.cfg > /dev/null"
+
+mkdir -p "${RESULTS_DIR}/associations"
+ctld sacctmgr -n -P show assoc format=account,user where user=root \
+    | awk -F'|' '$1 ~ /^bench/ { print $1 }' > "${RESULTS_DIR}/associations/leaves.txt"
+info "$(ctld sacctmgr -n -P show assoc format=id | wc -l) associations, $(wc -l < "${RESULTS_DIR}/associations/leaves.txt") leaf accounts"
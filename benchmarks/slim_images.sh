@@ -0,0 +1,156 @@
+#!/bin/bash
+#
+# The full image against the role-specific slim images (slim profile) at
+# NODES compute containers, one slurmd each:
+#
+#   image size       of the full image and of every role's image
+#   bring-up         `docker-compose up` of the compute containers until
+#                    every node has registered
+#   container start  per compute container, from created to started
+#   memory           per container after SETTLE seconds: RSS and page cache
+#                    of its memory cgroup
+#
+# All images are built first (the layers up to the Slurm build are shared),
+# tagged slurm-docker-cluster:slim-images[-<role>] so that the cluster's own
+# images are left alone, with the Slurm tag and configure options of the
+# cluster's image (IMAGE_TAG).  The whole cluster runs from them during the
+# benchmark.  The compute containers are removed before each variant so
+# that all of them start from the variant's image.
+#
+#     ./benchmarks/slim_images.sh [-n NODES] [-s SETTLE]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+NODES=200
+SETTLE=30
+TIMEOUT=900
+CLUSTER_TAG=${IMAGE_TAG:-19.05.1}
+BENCH_TAG=slim-images
+ROLES="slurmdbd slurmctld slurmd login"
+
+while getopts "n:s:" opt
+do
+    case "$opt" in
+        n) NODES=$OPTARG ;;
+        s) SETTLE=$OPTARG ;;
+        *) echo "usage: $0 [-n NODES] [-s SETTLE]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir slim_images)
+trap 'docker rm -f $(compute_containers) > /dev/null 2>&1; IMAGE_TAG=$CLUSTER_TAG compose up -d --remove-orphans > /dev/null; slurm_conf_reset; slurm_restart' EXIT
+
+# Build what the cluster runs: the Slurm tag and configure options of its
+# image, the Dockerfile's defaults if it has none.
+label='{{ index .Config.Labels "org.slurm-docker-cluster.%s" }}'
+build_args=()
+slurm_tag=$(docker image inspect -f "$(printf "$label" slurm-tag)" "slurm-docker-cluster:${CLUSTER_TAG}" 2> /dev/null || true)
+if [ -n "$slurm_tag" ]
+then
+    build_args+=(--build-arg SLURM_TAG="$slurm_tag"
+                 --build-arg SLURM_CONFIGURE_EXTRA="$(docker image inspect -f "$(printf "$label" configure-extra)" "slurm-docker-cluster:${CLUSTER_TAG}")")
+fi
+
+log "Building the images ${build_args[*]} ..."
+docker build "${build_args[@]}" -t "slurm-docker-cluster:${BENCH_TAG}" "$ROOT_DIR" > "${OUT}/build-full.log" 2>&1 \
+    || die "build failed, see ${OUT}/build-full.log"
+echo "full $(docker image inspect -f '{{.Size}}' "slurm-docker-cluster:${BENCH_TAG}")" > "${OUT}/sizes.txt"
+for role in $ROLES
+do
+    docker build "${build_args[@]}" --target "$role" -t "slurm-docker-cluster:${BENCH_TAG}-${role}" "$ROOT_DIR" \
+        > "${OUT}/build-${role}.log" 2>&1 || die "build failed, see ${OUT}/build-${role}.log"
+    echo "${role} $(docker image inspect -f '{{.Size}}' "slurm-docker-cluster:${BENCH_TAG}-${role}")" >> "${OUT}/sizes.txt"
+done
+export IMAGE_TAG=$BENCH_TAG
+
+# RSS and page cache in KiB of container $1's memory cgroup (v1 or v2).
+container_memory() {
+    docker exec "$1" sh -c 'cat /sys/fs/cgroup/memory/memory.stat 2> /dev/null || cat /sys/fs/cgroup/memory.stat' |
+        awk '$1 == "total_rss" || $1 == "anon" { rss = $2 }
+             $1 == "total_cache" || $1 == "file" { cache = $2 }
+             END { printf "%d %d\n", rss / 1024, cache / 1024 }'
+}
+
+for variant in full slim
+do
+    if [ "$variant" = "slim" ]
+    then
+        profiles=(--profile slim --profile topology)
+        image="slurm-docker-cluster:\${IMAGE_TAG:-19.05.1}-slurmd"
+    else
+        profiles=(--profile topology)
+        image="slurm-docker-cluster:\${IMAGE_TAG:-19.05.1}"
+    fi
+    "${ROOT_DIR}/generate_topology.py" --nodes "$NODES" --containers "$NODES" --image "$image" > /dev/null
+    slurm_conf_apply topology
+
+    log "${variant}: starting the controller ..."
+    docker rm -f $(compute_containers) > /dev/null 2>&1 || true
+    compose "${profiles[@]}" up -d --force-recreate slurmdbd slurmctld > /dev/null 2>&1
+    wait_for_slurmctld
+
+    log "${variant}: starting ${NODES} compute containers ..."
+    start=$(now_ms)
+    compose "${profiles[@]}" up -d > /dev/null 2>&1
+    until [ "$(ctld sinfo -h -N -t idle -o %N 2> /dev/null | sort -u | wc -l)" -ge "$NODES" ]
+    do
+        [ $(( $(now_ms) - start )) -lt $((TIMEOUT * 1000)) ] || die "not all ${NODES} nodes registered within ${TIMEOUT}s"
+        sleep 1
+    done
+    end=$(now_ms)
+    echo "${variant} $(( end - start ))" >> "${OUT}/bringup.txt"
+    info "${variant}: ${NODES} nodes registered after $(( end - start )) ms"
+
+    for container in $(compute_containers)
+    do
+        docker inspect -f '{{.Created}} {{.State.StartedAt}}' "$container" |
+            sed "s/^/${variant} ${container} /" >> "${OUT}/start.txt"
+    done
+
+    sleep "$SETTLE"
+    log "${variant}: measuring memory ..."
+    for container in slurmdbd slurmctld $(compute_containers)
+    do
+        echo "${variant} ${container} $(container_memory "$container")" >> "${OUT}/memory.txt"
+    done
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from startup import docker_time
+from stats import format_table, record, summarize
+out = sys.argv[1]
+
+print("%-10s %10s" % ("image", "size MB"))
+for line in open(os.path.join(out, "sizes.txt")):
+    image, size = line.split()
+    print("%-10s %10.0f" % (image, int(size) / 1e6))
+    record(out, "%s/image_mb" % image, [int(size) / 1e6], "MB")
+print()
+
+rows = OrderedDict()
+def add(key, value, unit):
+    rows.setdefault(key, ([], unit))[0].append(value)
+for line in open(os.path.join(out, "bringup.txt")):
+    variant, ms = line.split()
+    add("%s/bringup_s" % variant, int(ms) / 1000.0, "s")
+for line in open(os.path.join(out, "start.txt")):
+    variant, container, created, started = line.split()
+    add("%s/container_start_ms" % variant, (docker_time(started) - docker_time(created)) * 1000.0, "ms")
+for line in open(os.path.join(out, "memory.txt")):
+    variant, container, rss, cache = line.split()
+    role = container if container in ("slurmdbd", "slurmctld") else "compute"
+    add("%s/%s_rss_mb" % (variant, role), int(rss) / 1024.0, "MB")
+    add("%s/%s_cache_mb" % (variant, role), int(cache) / 1024.0, "MB")
+print(format_table(OrderedDict((k, summarize(v)) for k, (v, unit) in rows.items())))
+for variant in ("full", "slim"):
+    rss = rows.get("%s/compute_rss_mb" % variant, ([], ""))[0]
+    cache = rows.get("%s/compute_cache_mb" % variant, ([], ""))[0]
+    print("%s: %d compute containers, %.0f MB RSS and %.0f MB page cache in total"
+          % (variant, len(rss), sum(rss), sum(cache)))
+for k, (v, unit) in rows.items():
+    record(out, k, v, unit)
+PY
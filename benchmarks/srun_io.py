@@ -0,0 +1,169 @@
+"""srun stdout/stderr forwarding benchmark helper.
+
+Copied to the shared /data volume by srun_io.sh and run with the image's
+python3.4, so it must stay 3.4 compatible.
+
+    emit SECONDS RATE LENGTH FLUSH [STREAM]
+        Task side.  Print timestamped lines of LENGTH bytes at RATE lines per
+        second (0: as fast as possible) for SECONDS to STREAM (stdout or
+        stderr, default stdout), flushing every line when FLUSH is 1.
+    client VARIANT [--files GLOB] [--stderr] -- SRUN ARGS...
+        Client side.  Run srun, read its stdout (or with --stderr its stderr)
+        and print one JSON object with bytes/lines delivered, throughput, srun
+        CPU time and line latency.
+    report FILE [--record]
+        Host side.  Tabulate the JSON lines written by the client; with
+        --record, add throughput and latency to the run's results.
+"""
+
+import glob
+import json
+import os
+import random
+import resource
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from stats import format_table, record, summarize  # noqa: E402
+
+RESERVOIR = 100000
+
+
+def emit(seconds, rate, length, flush, stream="stdout"):
+    task = os.environ.get("SLURM_PROCID", "0")
+    pad = "x" * max(0, length - 40)
+    out = sys.stderr if stream == "stderr" else sys.stdout
+    end = time.time() + seconds
+    interval = 1.0 / rate if rate > 0 else 0
+    due = time.time()
+    while True:
+        now = time.time()
+        if now >= end:
+            break
+        out.write("%.6f %s %s\n" % (now, task, pad))
+        if flush:
+            out.flush()
+        if interval:
+            due += interval
+            delay = due - time.time()
+            if delay > 0:
+                time.sleep(delay)
+    out.flush()
+
+
+def parse_stamp(line):
+    # With --label, srun prefixes lines with "<task>: ".
+    fields = line.split()
+    for field in fields[:2]:
+        try:
+            return float(field)
+        except ValueError:
+            continue
+    return None
+
+
+def client(variant, files, stderr, srun_args):
+    latencies = []
+    samples = 0
+    lines = 0
+    nbytes = 0
+    start = time.time()
+    with open(os.devnull, "wb") as devnull:
+        if stderr:
+            proc = subprocess.Popen(srun_args, stdout=devnull, stderr=subprocess.PIPE)
+            stream = proc.stderr
+        else:
+            proc = subprocess.Popen(srun_args, stdout=subprocess.PIPE)
+            stream = proc.stdout
+        for raw in stream:
+            received = time.time()
+            lines += 1
+            nbytes += len(raw)
+            stamp = parse_stamp(raw.decode("ascii", "replace"))
+            if stamp is None:
+                continue
+            sample = (received - stamp) * 1000.0
+            samples += 1
+            if len(latencies) < RESERVOIR:
+                latencies.append(sample)
+            else:
+                slot = random.randint(0, samples - 1)
+                if slot < RESERVOIR:
+                    latencies[slot] = sample
+        rc = proc.wait()
+    elapsed = time.time() - start
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+
+    if files:
+        nbytes = sum(os.path.getsize(p) for p in glob.glob(files))
+        for path in glob.glob(files):
+            os.unlink(path)
+
+    result = {
+        "variant": variant,
+        "rc": rc,
+        "bytes": nbytes,
+        "lines": lines,
+        "elapsed_s": elapsed,
+        "mb_per_s": nbytes / elapsed / 1e6 if elapsed else 0,
+        "client_cpu_s": usage.ru_utime + usage.ru_stime,
+        "client_cpu_pct": 100.0 * (usage.ru_utime + usage.ru_stime) / elapsed,
+    }
+    if latencies:
+        result["latency_ms"] = summarize(latencies)
+    print(json.dumps(result))
+
+
+def report(path, save=False):
+    runs = {}
+    order = []
+    with open(path) as f:
+        for line in f:
+            run = json.loads(line)
+            if run["variant"] not in runs:
+                order.append(run["variant"])
+            runs.setdefault(run["variant"], []).append(run)
+
+    print("%-22s %6s %10s %10s %10s %10s %10s" % (
+        "variant", "runs", "MB/s", "cpu %", "lat p50", "lat p99", "lat max"))
+    for variant in order:
+        group = runs[variant]
+        mbs = summarize([r["mb_per_s"] for r in group])["p50"]
+        cpu = summarize([r["client_cpu_pct"] for r in group])["p50"]
+        lat = [r["latency_ms"] for r in group if "latency_ms" in r]
+        if lat:
+            cells = ["%10.1f" % max(l[k] for l in lat) for k in ("p50", "p99", "max")]
+        else:
+            cells = ["%10s" % "-"] * 3
+        print("%-22s %6d %10.2f %10.1f %s" % (variant, len(group), mbs, cpu, " ".join(cells)))
+        if save:
+            out = os.path.dirname(os.path.abspath(path))
+            record(out, "%s/mb_per_s" % variant, [r["mb_per_s"] for r in group], "MB/s")
+            record(out, "%s/latency_p99_ms" % variant, [l["p99"] for l in lat], "ms")
+    print("(MB/s and cpu: median over runs; latency in ms: worst run)")
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    action = sys.argv[1]
+    if action == "emit":
+        emit(float(sys.argv[2]), float(sys.argv[3]), int(sys.argv[4]), sys.argv[5] == "1", *sys.argv[6:7])
+    elif action == "client":
+        args = sys.argv[2:]
+        split = args.index("--")
+        options, srun_args = args[:split], args[split + 1:]
+        files = options[options.index("--files") + 1] if "--files" in options else None
+        client(options[0], files, "--stderr" in options, srun_args)
+    elif action == "report":
+        report(sys.argv[2], "--record" in sys.argv[3:])
+    else:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/bin/bash
+#
+# srun stdout/stderr forwarding throughput benchmark.
+#
+# Runs TASKS tasks per node on every compute node, each printing timestamped
+# lines, and reads the forwarded output with srun on the controller.  Each
+# variant (default, --label, --unbuffered, both, stderr, --output to files)
+# is run REPEAT times and reported as delivered MB/s, srun CPU use and line
+# latency.  srun runs with --overcommit, so TASKS may exceed the nodes' CPUs.
+#
+#     ./benchmarks/srun_io.sh [-n TASKS] [-r LINES_PER_SEC] [-d SECONDS]
+#                             [-l LINE_BYTES] [-R REPEAT]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+TASKS=4
+RATE=0
+DURATION=10
+LENGTH=100
+REPEAT=3
+WORK=/data/bench-io
+
+while getopts "n:r:d:l:R:" opt
+do
+    case "$opt" in
+        n) TASKS=$OPTARG ;;
+        r) RATE=$OPTARG ;;
+        d) DURATION=$OPTARG ;;
+        l) LENGTH=$OPTARG ;;
+        R) REPEAT=$OPTARG ;;
+        *) echo "usage: $0 [-n TASKS] [-r RATE] [-d SECONDS] [-l BYTES] [-R REPEAT]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir srun_io)
+NODES=$(compute_nodes | wc -l)
+NTASKS=$((NODES * TASKS))
+
+ctld mkdir -p "$WORK"
+for file in srun_io.py stats.py
+do
+    ctld_sh "cat > ${WORK}/${file}" < "${BENCH_DIR}/${file}"
+done
+
+# The base partition limits jobs to one node.
+ctld scontrol update PartitionName=normal MaxNodes=UNLIMITED
+trap 'ctld scontrol update PartitionName=normal MaxNodes=1' EXIT
+
+ctld srun --version > "${OUT}/version.txt"
+info "$(cat "${OUT}/version.txt"), ${NODES} nodes x ${TASKS} tasks, rate=${RATE}/s, ${DURATION}s, ${LENGTH}B lines"
+
+# run_variant VARIANT FLUSH STREAM [SRUN OPTION...]
+run_variant() {
+    local variant=$1 flush=$2 stream=$3
+    shift 3
+    local options=()
+    if [[ " $* " == *" --output="* ]]
+    then
+        options=(--files "${WORK}/out-*")
+    fi
+    [ "$stream" = stdout ] || options+=(--stderr)
+    ctld python3 "${WORK}/srun_io.py" client "$variant" "${options[@]}" -- \
+        srun -N "$NODES" -n "$NTASKS" --overcommit "$@" \
+        python3 "${WORK}/srun_io.py" emit "$DURATION" "$RATE" "$LENGTH" "$flush" "$stream" \
+        >> "${OUT}/runs.json"
+}
+
+for i in $(seq "$REPEAT")
+do
+    log "Round ${i}/${REPEAT} ..."
+    run_variant default 0 stdout
+    run_variant label 0 stdout --label
+    run_variant unbuffered 0 stdout --unbuffered
+    run_variant label+unbuffered 0 stdout --label --unbuffered
+    run_variant flush-every-line 1 stdout
+    run_variant stderr 0 stderr
+    run_variant stderr+label 0 stderr --label
+    run_variant output-files 0 stdout --output="${WORK}/out-%j-%t"
+done
+
+python3 "${BENCH_DIR}/srun_io.py" report "${OUT}/runs.json" --record | tee "${OUT}/summary.txt"
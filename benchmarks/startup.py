@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Startup waterfall of cluster bring-ups recorded by startup.sh.
+
+    benchmarks/startup.py [--record DIR] RUN_DIR...
+
+Every RUN_DIR holds one bring-up.  The phases of each container are put
+together from:
+
+    host.jsonl       startup.sh: compose up, register_cluster.sh, cluster ready
+    containers.txt   docker's start events of every container
+    startup.jsonl    docker-entrypoint.sh: munged, the wait loops, the daemon
+    mysql.log        `docker logs -t mysql`: database init, ready
+    slurmdbd.log     slurmdbd started
+    slurmctld.log    slurmctld started, state recovered, primary controller
+    nodes.txt        startup.sh's polling of sinfo: each node registered
+
+A phase lasts until the next phase of the same host; "ready" is a
+milestone.  A container that starts again (register_cluster.sh restarts
+slurmdbd and slurmctld) continues its row of phases with "#2".  A waterfall
+is printed per run and, for several runs, a table of phase durations.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import OrderedDict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from job_lifecycle import LOG_LINE, parse_time  # noqa: E402
+from stats import format_table, record, summarize  # noqa: E402
+
+WIDTH = 40
+READY = "ready"
+
+# (log file, host, pattern, phase starting at the matching line)
+LOG_PHASES = [
+    ("slurmdbd.log", "slurmdbd", re.compile(r"slurmdbd version \S+ started"), READY),
+    ("slurmctld.log", "slurmctld", re.compile(r"slurmctld version \S+ started"), "recover_state"),
+    ("slurmctld.log", "slurmctld", re.compile(r"Recovered information about \d+ jobs"), "init"),
+    ("slurmctld.log", "slurmctld", re.compile(r"Running as primary controller"), READY),
+]
+
+MYSQL_PHASES = [
+    (re.compile(r"Initializing database"), "init"),
+    (re.compile(r"MySQL init process done"), "mysqld"),
+    (re.compile(r"ready for connections.*port: 3306"), READY),
+]
+
+# Node states of a slurmd that has registered.
+REGISTERED = re.compile(r"^(idle|mixed|allocated|completing)$")
+
+
+def docker_time(text):
+    """RFC 3339 time of docker (nanoseconds, Z) as epoch seconds."""
+    stamp = text.rstrip("Z")
+    if "." in stamp:
+        stamp, frac = stamp.split(".")
+        stamp = "%s.%s" % (stamp, frac[:6])
+    return parse_time(stamp)
+
+
+def read_lines(path):
+    if not os.path.exists(path):
+        return []
+    with open(path) as f:
+        return [line.rstrip("\n") for line in f]
+
+
+def load_events(run_dir):
+    """[(t, host, phase)] of a run, sorted, from t0 (compose up) on."""
+    events = []
+    for line in read_lines(os.path.join(run_dir, "host.jsonl")):
+        e = json.loads(line)
+        events.append((e["t"], e["host"], e["phase"]))
+    t0 = min(t for t, host, phase in events)
+
+    for line in read_lines(os.path.join(run_dir, "containers.txt")):
+        nanoseconds, name = line.split()
+        events.append((int(nanoseconds) / 1e9, name, "start"))
+    for line in read_lines(os.path.join(run_dir, "startup.jsonl")):
+        e = json.loads(line)
+        events.append((e["t"], e["host"], e["phase"]))
+    for line in read_lines(os.path.join(run_dir, "mysql.log")):
+        stamp, _, message = line.partition(" ")
+        for pattern, phase in MYSQL_PHASES:
+            if pattern.search(message):
+                events.append((docker_time(stamp), "mysql", phase))
+    for name, host, pattern, phase in LOG_PHASES:
+        for line in read_lines(os.path.join(run_dir, name)):
+            match = LOG_LINE.match(line)
+            if match and pattern.search(match.group(2)):
+                events.append((parse_time(match.group(1)), host, phase))
+    registered = set()
+    for line in read_lines(os.path.join(run_dir, "nodes.txt")):
+        t, node, state = line.split()
+        if node not in registered and REGISTERED.match(state):
+            registered.add(node)
+            events.append((float(t), node, READY))
+    return sorted(e for e in events if e[0] >= t0)
+
+
+def phases(events):
+    """[(host, phase, start, end)] in order of start; end is None for a
+    milestone and for a phase still open at the end of the run."""
+    rows = []
+    open_phase = {}
+    seen = {}
+    for t, host, phase in events:
+        if host in open_phase:
+            rows[open_phase.pop(host)][3] = t
+        count = seen[(host, phase)] = seen.get((host, phase), 0) + 1
+        label = phase if count == 1 else "%s#%d" % (phase, count)
+        rows.append([host, label, t, None])
+        if phase != READY:
+            open_phase[host] = len(rows) - 1
+    return [tuple(r) for r in rows]
+
+
+def waterfall(name, rows):
+    t0 = rows[0][2]
+    total = max(max(r[2] for r in rows), max(r[3] or 0 for r in rows)) - t0
+    ready = [r[2] - t0 for r in rows if r[0] == "cluster" and r[1] == READY]
+    lines = ["%s: cluster ready after %s" % (name, "%.2fs" % ready[-1] if ready else "(never)")]
+    lines.append("%8s %9s  %-10s %-18s" % ("offset", "duration", "host", "phase"))
+    for host, phase, start, end in rows:
+        a = int(WIDTH * (start - t0) / total) if total else 0
+        if end is None:
+            duration = "-" if phase.startswith(READY) else "open"
+            bar = " " * a + "|"
+        else:
+            duration = "%.2fs" % (end - start)
+            bar = " " * a + "#" * max(1, int(WIDTH * (end - start) / total) if total else 1)
+        lines.append("%7.2fs %9s  %-10s %-18s %s" % (start - t0, duration, host, phase,
+                                                   bar[:WIDTH + 1].ljust(WIDTH + 1) + "|"))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("runs", nargs="+", help="bring-up directories of startup.sh")
+    parser.add_argument("--record", metavar="DIR", help="record the phase durations for DIR's run")
+    args = parser.parse_args()
+
+    durations = OrderedDict()
+    for run_dir in args.runs:
+        rows = phases(load_events(run_dir))
+        if not rows:
+            print("%s: no events" % run_dir)
+            continue
+        print(waterfall(os.path.basename(run_dir.rstrip("/")), rows))
+        print()
+        t0 = rows[0][2]
+        for host, phase, start, end in rows:
+            if phase.startswith(READY):
+                durations.setdefault("%s/%s_s" % (host, phase), []).append(start - t0)
+            elif end is not None:
+                durations.setdefault("%s/%s_s" % (host, phase), []).append(end - start)
+
+    if len(args.runs) > 1:
+        print(format_table(OrderedDict((k, summarize(v)) for k, v in durations.items()),
+                           label="phase [s]", digits=2))
+    if args.record:
+        for key, values in durations.items():
+            record(args.record, key, values, "s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/bin/bash
+#
+# Cluster bring-up time: `docker-compose up -d` followed by
+# register_cluster.sh, broken down into the phases of every container
+# (startup.py).
+#
+#   cold   every bring-up starts from fresh volumes: MySQL initializes its
+#          data directory and the cluster has to be registered
+#   warm   the volumes of a first, unmeasured bring-up are kept: MySQL,
+#          slurmdbd and slurmctld recover their state
+#
+# Like matrix.sh, the cluster runs as its own compose project (slurm-startup)
+# whose volumes are removed afterwards, so the cluster's containers must be
+# removed first (`docker-compose down`, which keeps the volumes).  While the
+# cluster comes up, sinfo is polled every POLL_INTERVAL ms for the nodes'
+# registration.
+#
+#     ./benchmarks/startup.sh [-m cold|warm] [-n REPEATS]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+MODE=cold
+REPEATS=3
+TIMEOUT=600
+POLL_INTERVAL=200
+
+while getopts "m:n:" opt
+do
+    case "$opt" in
+        m) MODE=$OPTARG ;;
+        n) REPEATS=$OPTARG ;;
+        *) echo "usage: $0 [-m cold|warm] [-n REPEATS]" >&2; exit 2 ;;
+    esac
+done
+case "$MODE" in
+    cold|warm) ;;
+    *) die "unknown mode ${MODE}" ;;
+esac
+
+require_project slurm-startup
+export COMPOSE_PROJECT_NAME=slurm-startup
+
+OUT=$(output_dir startup)
+trap 'compose down -v > /dev/null 2>&1' EXIT
+compose down -v > /dev/null 2>&1
+
+# A milestone of the bring-up as a whole, in the format of the entrypoint's
+# startup log.
+milestone() {
+    printf '{"t": %s, "host": "cluster", "role": "host", "phase": "%s"}\n' \
+        "$(date +%s.%N)" "$1" >> "${run}/host.jsonl"
+}
+
+# Poll the node states into $1 until the file $2 exists.
+poll_nodes() {
+    until [ -e "$2" ]
+    do
+        ctld sinfo -h -N -o "%N %T" 2> /dev/null | sed "s/^/$(date +%s.%N) /" >> "$1" || true
+        sleep "$(awk -v ms="$POLL_INTERVAL" 'BEGIN { print ms / 1000 }')"
+    done
+}
+
+registered() {
+    ctld sacctmgr -n show cluster format=cluster 2> /dev/null | grep -qw "$CLUSTER"
+}
+
+if [ "$MODE" = "warm" ]
+then
+    log "Preparing the volumes ..."
+    compose up -d > /dev/null
+    wait_for_mysql
+    ensure_cluster_registered
+    wait_for_nodes
+fi
+
+RUNS=()
+for i in $(seq "$REPEATS")
+do
+    run="${OUT}/run-${i}"
+    RUNS+=("$run")
+    mkdir -p "$run"
+    if [ "$MODE" = "cold" ]
+    then
+        compose down -v > /dev/null 2>&1
+    else
+        compose down > /dev/null 2>&1
+    fi
+
+    log "Bring-up ${i} of ${REPEATS} (${MODE}) ..."
+    since=$(date +%s)
+    rm -f "${run}/.stop"
+    milestone compose_up
+    compose up -d > /dev/null 2>&1
+    poll_nodes "${run}/nodes.txt" "${run}/.stop" &
+    poller=$!
+
+    milestone wait_slurmctld
+    until ctld scontrol ping 2> /dev/null | grep -q "UP"
+    do
+        [ $(( $(date +%s) - since )) -lt "$TIMEOUT" ] || die "slurmctld did not come up within ${TIMEOUT}s"
+        sleep 0.2
+    done
+    if ! registered
+    then
+        milestone register_cluster
+        # register_cluster.sh fails until slurmdbd has connected to MySQL.
+        until (cd "$ROOT_DIR" && ./register_cluster.sh) > "${run}/register_cluster.log" 2>&1
+        do
+            [ $(( $(date +%s) - since )) -lt "$TIMEOUT" ] || die "register_cluster.sh did not succeed within ${TIMEOUT}s"
+            sleep 1
+        done
+    fi
+    milestone wait_nodes
+    until registered && [ -z "$(ctld sinfo -h -N -t down,no_respond,unknown -o %N 2> /dev/null)" ]
+    do
+        [ $(( $(date +%s) - since )) -lt "$TIMEOUT" ] || die "the nodes did not register within ${TIMEOUT}s"
+        sleep 0.2
+    done
+    milestone ready
+    touch "${run}/.stop"
+    wait "$poller" || true
+
+    docker events --since "$since" --until "$(date +%s)" --filter type=container --filter event=start \
+        --filter "label=com.docker.compose.project=${COMPOSE_PROJECT_NAME}" \
+        --format '{{.TimeNano}} {{.Actor.Attributes.name}}' > "${run}/containers.txt"
+    docker logs -t mysql > "${run}/mysql.log" 2>&1
+    for file in startup.jsonl slurmdbd.log slurmctld.log
+    do
+        ctld cat "/var/log/slurm/${file}" > "${run}/${file}" 2> /dev/null || true
+    done
+    info "ready after $(python3 "${BENCH_DIR}/startup.py" "$run" | sed -n '1s/.* after //p')"
+done
+
+python3 "${BENCH_DIR}/startup.py" --record "$OUT" "${RUNS[@]}" | tee "${OUT}/summary.txt"
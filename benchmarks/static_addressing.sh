@@ -0,0 +1,99 @@
+#!/bin/bash
+#
+# Name resolution through Docker's embedded DNS against static addresses and
+# a generated /etc/hosts (generate_topology.py --subnet), at NODES compute
+# containers:
+#
+#   register   `docker-compose up` until every node has registered
+#   lookup     resolving every node name on the controller, per lookup
+#   launch     `srun -N1 -w NODE true` on the controller, round robin over
+#              the nodes, REPEATS times
+#
+# The network is recreated for each mode, so the cluster is taken down
+# (keeping its volumes) before each and brought back up afterwards.
+#
+#     ./benchmarks/static_addressing.sh [-n NODES] [-c CONTAINERS] [-r REPEATS] [-s SUBNET]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+NODES=200
+CONTAINERS=""
+REPEATS=200
+SUBNET=172.28.0.0/16
+TIMEOUT=900
+
+while getopts "n:c:r:s:" opt
+do
+    case "$opt" in
+        n) NODES=$OPTARG ;;
+        c) CONTAINERS=$OPTARG ;;
+        r) REPEATS=$OPTARG ;;
+        s) SUBNET=$OPTARG ;;
+        *) echo "usage: $0 [-n NODES] [-c CONTAINERS] [-r REPEATS] [-s SUBNET]" >&2; exit 2 ;;
+    esac
+done
+CONTAINERS=${CONTAINERS:-$NODES}
+
+OUT=$(output_dir static_addressing)
+trap 'compose --profile topology down > /dev/null 2>&1; compose up -d > /dev/null 2>&1; slurm_conf_reset; slurm_restart' EXIT
+
+for mode in dns static
+do
+    if [ "$mode" = "static" ]
+    then
+        "${ROOT_DIR}/generate_topology.py" --nodes "$NODES" --containers "$CONTAINERS" --subnet "$SUBNET"
+    else
+        "${ROOT_DIR}/generate_topology.py" --nodes "$NODES" --containers "$CONTAINERS"
+    fi
+    slurm_conf_apply topology
+    log "${mode}: recreating the cluster ..."
+    compose --profile topology down > /dev/null 2>&1
+
+    start=$(now_ms)
+    compose --profile topology up -d > /dev/null 2>&1
+    until [ "$(ctld sinfo -h -N -t idle -o %N 2> /dev/null | sort -u | wc -l)" -ge "$NODES" ]
+    do
+        [ $(( $(now_ms) - start )) -lt $((TIMEOUT * 1000)) ] || die "not all ${NODES} nodes registered within ${TIMEOUT}s"
+        sleep 1
+    done
+    echo "${mode} $(( $(now_ms) - start ))" >> "${OUT}/register.txt"
+    info "${mode}: ${NODES} nodes registered after $(( $(now_ms) - start )) ms"
+    ensure_cluster_registered
+
+    log "${mode}: resolving the node names ..."
+    compute_containers | ctld python3 -c '
+import socket, sys, time
+names = sys.stdin.read().split()
+for i in range(3):
+    for name in names:
+        start = time.time()
+        socket.getaddrinfo(name, 6818, socket.AF_INET, socket.SOCK_STREAM)
+        print("%.3f" % ((time.time() - start) * 1000.0))
+' | sed "s/^/${mode} /" >> "${OUT}/lookup.txt"
+
+    log "${mode}: ${REPEATS} launches ..."
+    nodes=$(compute_nodes | tr '\n' ' ')
+    ctld_sh "nodes=(${nodes}); for i in \$(seq ${REPEATS}); do
+                 s=\$(date +%s%N); srun -N1 -w \${nodes[i % \${#nodes[@]}]} true; e=\$(date +%s%N)
+                 echo \$(( (e - s) / 1000000 ))
+             done" | sed "s/^/${mode} /" >> "${OUT}/launch.txt"
+done
+
+python3 - "$OUT" "$BENCH_DIR" <<'PY' | tee "${OUT}/summary.txt"
+import os, sys
+from collections import OrderedDict
+sys.path.insert(0, sys.argv[2])
+from stats import format_table, record, summarize
+out = sys.argv[1]
+rows = OrderedDict()
+for name, metric, scale, unit in (("register", "register_s", 1000.0, "s"),
+                                  ("lookup", "lookup_ms", 1.0, "ms"),
+                                  ("launch", "launch_ms", 1.0, "ms")):
+    for line in open(os.path.join(out, "%s.txt" % name)):
+        mode, value = line.split()
+        rows.setdefault("%s/%s" % (mode, metric), ([], unit))[0].append(float(value) / scale)
+print(format_table(OrderedDict((k, summarize(v)) for k, (v, unit) in rows.items()), digits=2))
+for k, (v, unit) in rows.items():
+    record(out, k, v, unit)
+PY
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Summary statistics shared by the benchmark scripts.
+
+As a command, reads one number per line from stdin (or the files given) and
+prints count, mean and percentiles:
+
+    ... | benchmarks/stats.py --label submit_ms
+
+With --by-key, lines are "<key> <number>" and one row is printed per key.
+With --record DIR the samples are also added to the results of the run in
+DIR (see record()).
+"""
+
+import argparse
+import json
+import math
+import os
+import sys
+from collections import OrderedDict
+
+PERCENTILES = (50, 90, 99)
+
+
+def percentile(values, pct):
+    """Percentile of a sorted list using linear interpolation."""
+    if not values:
+        return float("nan")
+    k = (len(values) - 1) * pct / 100.0
+    lo = math.floor(k)
+    hi = math.ceil(k)
+    if lo == hi:
+        return values[int(k)]
+    return values[lo] + (values[hi] - values[lo]) * (k - lo)
+
+
+def summarize(values):
+    """Return a dict with count, mean, min, max and the PERCENTILES."""
+    values = sorted(values)
+    summary = {
+        "count": len(values),
+        "mean": sum(values) / len(values) if values else float("nan"),
+        "min": values[0] if values else float("nan"),
+        "max": values[-1] if values else float("nan"),
+    }
+    for pct in PERCENTILES:
+        summary["p%d" % pct] = percentile(values, pct)
+    return summary
+
+
+COLUMNS = ["count", "mean", "min"] + ["p%d" % p for p in PERCENTILES] + ["max"]
+
+
+# Metrics whose name contains one of these are better when higher.
+HIGHER_IS_BETTER = ("per_s", "utilization", "throughput")
+
+
+def better(metric):
+    """"higher" or "lower": the direction in which metric improves."""
+    return "higher" if any(word in metric for word in HIGHER_IS_BETTER) else "lower"
+
+
+def record(out_dir, metric, values, unit=""):
+    """Append the samples of one metric to <out_dir>/metrics.jsonl.
+
+    Together with run.json, written by output_dir in lib.sh, this is what
+    report.py compares across runs.  A metric may be recorded more than once
+    per run; report.py pools the samples.
+    """
+    with open(os.path.join(out_dir, "metrics.jsonl"), "a") as f:
+        f.write(json.dumps({"metric": metric, "unit": unit, "better": better(metric),
+                            "values": [float(v) for v in values]}) + "\n")
+
+
+def format_table(rows, label="metric", digits=1):
+    """Format {label: summary} rows as an aligned text table."""
+    width = max([len(label)] + [len(name) for name in rows])
+    lines = [label.ljust(width) + "".join(c.rjust(10) for c in COLUMNS)]
+    for name, summary in rows.items():
+        cells = []
+        for column in COLUMNS:
+            value = summary[column]
+            if column == "count":
+                cells.append(str(value).rjust(10))
+            else:
+                cells.append("{:.{}f}".format(value, digits).rjust(10))
+        lines.append(name.ljust(width) + "".join(cells))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="*", help="input files (default: stdin)")
+    parser.add_argument("--label", default="value")
+    parser.add_argument("--by-key", action="store_true",
+                        help='input lines are "<key> <number>"')
+    parser.add_argument("--digits", type=int, default=1)
+    parser.add_argument("--record", metavar="DIR", help="record the samples for DIR's run")
+    parser.add_argument("--unit", default="", help="unit of the recorded samples")
+    args = parser.parse_args()
+
+    groups = OrderedDict()
+    streams = [open(f) for f in args.files] if args.files else [sys.stdin]
+    for stream in streams:
+        for line in stream:
+            fields = line.split()
+            if not fields:
+                continue
+            if args.by_key:
+                groups.setdefault(fields[0], []).append(float(fields[1]))
+            else:
+                groups.setdefault(args.label, []).append(float(fields[0]))
+    rows = OrderedDict((key, summarize(values)) for key, values in groups.items())
+    print(format_table(rows, digits=args.digits))
+    if args.record:
+        for key, values in groups.items():
+            record(args.record, key, values, args.unit)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+"""Open a storm of client connections against slurmctld.
+
+Run inside a container with the Slurm clients (python3.4 from the image):
+
+    python3 - CONCURRENCY SECONDS COMMAND... < storm.py
+
+CONCURRENCY threads run COMMAND back to back for SECONDS and print one
+"<start epoch ms> <latency ms> <exit code> <retries>" line per run.
+Retries are the lines of COMMAND's stderr in which the client says it is
+retrying (a refused or timed out connection, slurmctld busy).
+"""
+
+import re
+import subprocess
+import sys
+import threading
+import time
+
+RETRY = re.compile(r"retry|retrying|sleeping and retrying", re.I)
+
+
+def worker(command, deadline, lock):
+    while time.time() < deadline:
+        start = time.time()
+        proc = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                                universal_newlines=True)
+        _, err = proc.communicate()
+        elapsed = time.time() - start
+        retries = sum(1 for line in err.splitlines() if RETRY.search(line))
+        with lock:
+            sys.stdout.write("%d %.1f %d %d\n" % (start * 1000, elapsed * 1000,
+                                                  proc.returncode, retries))
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    concurrency, seconds, command = int(sys.argv[1]), float(sys.argv[2]), sys.argv[3:]
+    deadline = time.time() + seconds
+    lock = threading.Lock()
+    threads = [threading.Thread(target=worker, args=(command, deadline, lock))
+               for _ in range(concurrency)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,76 @@
+"""Time-to-first-prompt of interactive allocations through a pseudo-terminal.
+
+Run inside the login container (python3.4 from the image):
+
+    python3 - COUNT TIMEOUT COMMAND... < time_to_shell.py
+
+Starts COMMAND (e.g. srun --pty bash) COUNT times on a pty with a unique
+prompt, waits for the prompt, leaves the shell and prints one
+"<milliseconds>" line per attempt, or "timeout" when no prompt appeared
+within TIMEOUT seconds.
+"""
+
+import os
+import pty
+import select
+import signal
+import sys
+import time
+
+MARKER = b"TTS_PROMPT_READY"
+
+
+def attempt(command, timeout):
+    env = dict(os.environ, PS1=MARKER.decode() + "$ ", TERM="dumb")
+    start = time.time()
+    pid, fd = pty.fork()
+    if pid == 0:
+        os.execvpe(command[0], command, env)
+    seen = b""
+    latency = None
+    while time.time() - start < timeout:
+        ready, _, _ = select.select([fd], [], [], 0.05)
+        if not ready:
+            continue
+        try:
+            data = os.read(fd, 4096)
+        except OSError:
+            break
+        if not data:
+            break
+        seen = (seen + data)[-256:]
+        if MARKER in seen:
+            latency = (time.time() - start) * 1000.0
+            break
+    try:
+        os.write(fd, b"exit\n")
+        deadline = time.time() + 10
+        while time.time() < deadline:
+            done, _ = os.waitpid(pid, os.WNOHANG)
+            if done:
+                break
+            ready, _, _ = select.select([fd], [], [], 0.1)
+            if ready:
+                os.read(fd, 4096)
+        else:
+            os.kill(pid, signal.SIGKILL)
+            os.waitpid(pid, 0)
+    except OSError:
+        pass
+    os.close(fd)
+    return latency
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    count, timeout, command = int(sys.argv[1]), float(sys.argv[2]), sys.argv[3:]
+    for _ in range(count):
+        latency = attempt(command, timeout)
+        print("timeout" if latency is None else "%.1f" % latency)
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
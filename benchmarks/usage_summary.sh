@@ -0,0 +1,72 @@
+#!/bin/bash
+#
+# Cost of maintaining the daily usage summaries and speed of the dashboard
+# queries they answer, compared with the equivalent sreport/sacct queries.
+#
+#     ./benchmarks/seed_accounting.sh -n 1000000
+#     ./benchmarks/usage_summary.sh [-n NEW_JOBS] [-d DAYS] [-R REPEAT]
+set -e
+
+. "$(dirname "$0")/lib.sh"
+
+NEW_JOBS=100
+DAYS=30
+REPEAT=5
+
+while getopts "n:d:R:" opt
+do
+    case "$opt" in
+        n) NEW_JOBS=$OPTARG ;;
+        d) DAYS=$OPTARG ;;
+        R) REPEAT=$OPTARG ;;
+        *) echo "usage: $0 [-n NEW_JOBS] [-d DAYS] [-R REPEAT]" >&2; exit 2 ;;
+    esac
+done
+
+OUT=$(output_dir usage_summary)
+SINCE=$(date -u -d "-${DAYS} days" +%Y-%m-%d)
+SUMMARY="env SUMMARY_HOST=mysql CLUSTER=${CLUSTER} slurm-usage-summary"
+
+# Print the wall time of a command on the controller in ms as "<label> <ms>".
+timed() {
+    local label=$1 start
+    shift
+    start=$(now_ms)
+    ctld_sh "$*" > /dev/null
+    echo "${label} $(( $(now_ms) - start ))"
+}
+
+log "Dropping existing summaries ..."
+acct_db -e "DROP TABLE IF EXISTS summary_${CLUSTER}_daily, summary_${CLUSTER}_seen, summary_${CLUSTER}_state"
+
+log "Full summarization of the existing job table ..."
+timed update_full "$SUMMARY update" | tee -a "${OUT}/times.txt"
+
+log "Incremental summarization after ${NEW_JOBS} new jobs ..."
+for i in $(seq "$NEW_JOBS")
+do
+    submit --output=/dev/null --wrap=true > /dev/null
+done
+wait_for_empty_queue
+wait_for_dbd_agent
+timed update_incremental "$SUMMARY update" | tee -a "${OUT}/times.txt"
+timed update_noop "$SUMMARY update" | tee -a "${OUT}/times.txt"
+
+log "Dashboard queries over ${DAYS} days, ${REPEAT} times each ..."
+for i in $(seq "$REPEAT")
+do
+    timed summary_top_users "$SUMMARY report --by user -S $SINCE --top 10"
+    timed summary_by_account "$SUMMARY report --by account -S $SINCE"
+    timed summary_daily "$SUMMARY report --by day -S $SINCE"
+    timed sreport_top_users "sreport -n user topusage start=$SINCE end=now TopCount=10"
+    timed sreport_by_account "sreport -n cluster AccountUtilizationByUser start=$SINCE end=now"
+    timed sacct_range "sacct -a -X -n -P -S $SINCE -E now -o User,Account,CPUTimeRAW"
+done >> "${OUT}/queries.txt"
+
+{
+    echo "Summarization (ms):"
+    cat "${OUT}/times.txt"
+    echo
+    echo "Queries (ms):"
+    python3 "${BENCH_DIR}/stats.py" --by-key --unit ms --record "$OUT" "${OUT}/queries.txt"
+} | tee "${OUT}/summary.txt"
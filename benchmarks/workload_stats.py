@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Scheduling quality of a finished workload from sacct records.
+
+Input is `sacct -n -P -X -o JobID,JobName,Submit,Start,End,AllocCPUS,State`.
+Jobs are grouped by job name.  Per group: job count, wait time percentiles
+and mean bounded slowdown; overall: makespan and CPU utilization over the
+makespan for a cluster of --cpus CPUs.
+
+    benchmarks/workload_stats.py --cpus 2 sacct.txt [--json] [--record DIR --label RUN]
+
+--record adds the wait times and utilization to the results of the run in
+DIR, as "<RUN>/<group>/wait_s" and "<RUN>/utilization".
+"""
+
+import argparse
+import calendar
+import json
+import os
+import sys
+from collections import OrderedDict
+from datetime import datetime
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from stats import percentile, record  # noqa: E402
+
+# Runtimes below this many seconds count as this long in bounded slowdown.
+SLOWDOWN_BOUND = 10
+
+
+def epoch(text):
+    return calendar.timegm(datetime.strptime(text, "%Y-%m-%dT%H:%M:%S").timetuple())
+
+
+def read_jobs(path):
+    jobs = []
+    with open(path) as f:
+        for line in f:
+            fields = line.rstrip("\n").split("|")
+            if len(fields) < 7 or not fields[4][:1].isdigit() or not fields[3][:1].isdigit():
+                continue
+            jobs.append({
+                "name": fields[1],
+                "submit": epoch(fields[2]),
+                "start": epoch(fields[3]),
+                "end": epoch(fields[4]),
+                "cpus": int(fields[5] or 0),
+                "state": fields[6].split()[0],
+            })
+    return jobs
+
+
+def analyze(jobs, cpus):
+    groups = OrderedDict()
+    for job in sorted(jobs, key=lambda j: j["name"]):
+        groups.setdefault(job["name"], []).append(job)
+    groups["all"] = jobs
+
+    result = OrderedDict()
+    for name, members in groups.items():
+        waits = sorted(j["start"] - j["submit"] for j in members)
+        slowdowns = [
+            max(1.0, (j["end"] - j["submit"]) / float(max(j["end"] - j["start"], SLOWDOWN_BOUND)))
+            for j in members]
+        result[name] = OrderedDict([
+            ("jobs", len(members)),
+            ("wait_mean", sum(waits) / len(waits) if waits else 0.0),
+            ("wait_p50", percentile(waits, 50)),
+            ("wait_p90", percentile(waits, 90)),
+            ("wait_max", waits[-1] if waits else 0.0),
+            ("bounded_slowdown", sum(slowdowns) / len(slowdowns) if slowdowns else 0.0),
+        ])
+    if jobs:
+        first = min(j["submit"] for j in jobs)
+        last = max(j["end"] for j in jobs)
+        makespan = max(last - first, 1)
+        used = sum(j["cpus"] * (j["end"] - j["start"]) for j in jobs)
+        result["all"]["makespan"] = makespan
+        result["all"]["utilization"] = used / float(cpus * makespan) if cpus else 0.0
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("sacct", help="sacct output file")
+    parser.add_argument("--cpus", type=int, required=True, help="CPUs in the cluster")
+    parser.add_argument("--json", action="store_true")
+    parser.add_argument("--record", metavar="DIR", help="record with the results of DIR's run")
+    parser.add_argument("--label", default="workload", help="metric prefix for --record")
+    args = parser.parse_args()
+
+    jobs = read_jobs(args.sacct)
+    result = analyze(jobs, args.cpus)
+    if args.record:
+        for name in result:
+            waits = [j["start"] - j["submit"] for j in jobs if name in ("all", j["name"])]
+            record(args.record, "%s/%s/wait_s" % (args.label, name), waits, "s")
+        if "utilization" in result.get("all", {}):
+            record(args.record, "%s/utilization" % args.label, [result["all"]["utilization"]])
+    if args.json:
+        print(json.dumps(result))
+        return
+    print("%-12s %6s %10s %10s %10s %10s %10s" % (
+        "group", "jobs", "wait mean", "wait p50", "wait p90", "wait max", "bsld"))
+    for name, r in result.items():
+        print("%-12s %6d %10.1f %10.1f %10.1f %10.1f %10.2f" % (
+            name, r["jobs"], r["wait_mean"], r["wait_p50"], r["wait_p90"],
+            r["wait_max"], r["bounded_slowdown"]))
+    if "makespan" in result.get("all", {}):
+        print("makespan %ds, utilization %.1f%%" % (
+            result["all"]["makespan"], 100 * result["all"]["utilization"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,11 +1,26 @@
 #!/bin/bash
 set -e
 
+# Bring-up milestones of every container are appended to one structured log on
+# the shared var_log_slurm volume, one JSON object per line: the phase named
+# "phase" of "host" starts at "t" (epoch seconds) and the previous phase of
+# that host ends.  benchmarks/startup.py turns it into a startup waterfall.
+STARTUP_LOG=/var/log/slurm/startup.jsonl
+
+phase() {
+    printf '{"t": %s, "host": "%s", "role": "%s", "phase": "%s"}\n' \
+        "$(date +%s.%N)" "$(hostname)" "$ROLE" "$1" >> "$STARTUP_LOG" || true
+}
+
+ROLE=$1
+
 if [ "$1" = "slurmdbd" ]
 then
+    phase munged
     echo "---> Starting the MUNGE Authentication service (munged) ..."
     gosu munge /usr/sbin/munged
 
+    phase wait_mysql
     echo "---> Starting the Slurm Database Daemon (slurmdbd) ..."
 
     {
@@ -18,14 +33,17 @@ then
     }
     echo "-- Database is now active ..."
 
+    phase slurmdbd
     exec gosu slurm /usr/sbin/slurmdbd -Dvvv
 fi
 
 if [ "$1" = "slurmctld" ]
 then
+    phase munged
     echo "---> Starting the MUNGE Authentication service (munged) ..."
     gosu munge /usr/sbin/munged
 
+    phase wait_slurmdbd
     echo "---> Waiting for slurmdbd to become active before starting slurmctld ..."
 
     until 2>/dev/null >/dev/tcp/slurmdbd/6819
@@ -35,15 +53,25 @@ then
     done
     echo "-- slurmdbd is now active ..."
 
+    if [ -n "$SLURM_CONFIG_SERVE" ]
+    then
+        phase config_serve
+        echo "---> Publishing the Slurm configuration on port 6820 ..."
+        slurm-config serve &
+    fi
+
+    phase slurmctld
     echo "---> Starting the Slurm Controller Daemon (slurmctld) ..."
     exec gosu slurm /usr/sbin/slurmctld -Dvvv
 fi
 
 if [ "$1" = "slurmd" ]
 then
+    phase munged
     echo "---> Starting the MUNGE Authentication service (munged) ..."
     gosu munge /usr/sbin/munged
 
+    phase wait_slurmctld
     echo "---> Waiting for slurmctld to become active before starting slurmd..."
 
     until 2>/dev/null >/dev/tcp/slurmctld/6817
@@ -53,8 +81,62 @@ then
     done
     echo "-- slurmctld is now active ..."
 
+    if [ -n "$SLURM_CONFIG_SERVER" ]
+    then
+        phase config_fetch
+        echo "---> Fetching the Slurm configuration from ${SLURM_CONFIG_SERVER} ..."
+        slurm-config fetch --once
+        slurm-config fetch --watch &
+    fi
+
+    if [ -n "$SLURMD_NODENAMES" ]
+    then
+        # Emulated nodes: one slurmd per node name (needs a build with
+        # --enable-multiple-slurmd, see generate_topology.py).
+        phase slurmd
+        echo "---> Starting the Slurm Node Daemons (slurmd) for ${SLURMD_NODENAMES} ..."
+        for node in $(scontrol show hostnames "$SLURMD_NODENAMES")
+        do
+            mkdir -p "/var/spool/slurmd/${node}"
+            /usr/sbin/slurmd -D -N "$node" &
+        done
+        wait
+        exit 1
+    fi
+
+    phase slurmd
     echo "---> Starting the Slurm Node Daemon (slurmd) ..."
-    exec /usr/sbin/slurmd -Dvvv
+    exec /usr/local/libexec/slurm/node-supervisor
+fi
+
+if [ "$1" = "login" ]
+then
+    phase munged
+    echo "---> Starting the MUNGE Authentication service (munged) ..."
+    gosu munge /usr/sbin/munged
+
+    phase wait_slurmctld
+    echo "---> Waiting for slurmctld to become active before accepting logins ..."
+
+    until 2>/dev/null >/dev/tcp/slurmctld/6817
+    do
+        echo "-- slurmctld is not available.  Sleeping ..."
+        sleep 2
+    done
+    echo "-- slurmctld is now active ..."
+
+    if [ $# -gt 1 ]
+    then
+        # A service on the login node, e.g. `login slurm-gateway`.
+        shift
+        phase "$1"
+        echo "---> Starting $1 ..."
+        exec "$@"
+    fi
+
+    phase ready
+    echo "---> Login node ready; use docker exec to run Slurm commands ..."
+    exec tail -f /dev/null
 fi
 
 exec "$@"
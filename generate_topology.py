@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""Generate a cluster topology as the `topology` profile.
+
+Writes profiles/topology/ with
+
+    docker-compose.yml   compute containers c1..cCONTAINERS
+    nodes.conf           NodeName/PartitionName lines replacing those of
+                         slurm.conf
+    slurm.conf           settings the topology needs
+
+With as many nodes as containers every container runs one slurmd, node names
+are the container names, as in the base cluster.  With more nodes than
+containers the nodes e1..eNODES are emulated: every container runs several
+slurmd daemons, each on its own port.  That needs an image built with
+`--build-arg SLURM_CONFIGURE_EXTRA=--enable-multiple-slurmd`.
+
+With --config-server the containers fetch slurm.conf from the controller
+(config-push profile) instead of sharing the etc_slurm volume.
+
+With --subnet the compose network gets that subnet and mysql, slurmdbd,
+slurmctld and the compute containers static addresses in it.  slurm.conf
+gets NodeAddr/ControlAddr, and every container but mysql gets the generated
+hosts file as /etc/hosts, so that no name is looked up through Docker's DNS.
+Other containers are given addresses from the last /24 of the subnet.
+
+With --isolation the containers take the compute CPUs and I/O weight of the
+isolation profile.
+
+    ./generate_topology.py --nodes 500 --containers 10
+    ./generate_topology.py --nodes 200 --subnet 172.28.0.0/16
+    docker-compose -f docker-compose.yml -f profiles/topology/docker-compose.yml up -d
+"""
+
+import argparse
+import ipaddress
+import os
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+FIRST_PORT = 17001
+
+SERVICE = """\
+  {name}:
+    image: {image}
+    command: ["slurmd"]
+    hostname: {name}
+    container_name: {name}
+    labels:
+      org.slurm-docker-cluster.role: compute
+    environment:
+      SLURMD_NODENAMES: "{nodenames}"{environment}
+    volumes:
+      - etc_munge:/etc/munge
+      - {etc_slurm}
+      - slurm_jobdir:/data
+      - var_log_slurm:/var/log/slurm{hosts}
+    expose:
+      - "6818"{ports}
+    depends_on:
+      - "slurmctld"{network}{isolation}
+"""
+
+# Static address (and hosts file) of a service of the base compose file.
+BASE_SERVICE = """\
+  {name}:{network}{volumes}
+"""
+
+NETWORK = """
+    networks:
+      default:
+        ipv4_address: {address}"""
+
+# The compute side of the isolation profile.
+ISOLATION = """
+    cpuset: "${COMPUTE_CPUS}"
+    blkio_config:
+      weight: ${COMPUTE_IO_WEIGHT}"""
+
+HOSTS_VOLUME = """
+      - {hosts}:/etc/hosts:ro"""
+
+BASE_SERVICES = ("mysql", "slurmdbd", "slurmctld")
+
+
+def hostlist(prefix, first, last):
+    if first == last:
+        return "%s%d" % (prefix, first)
+    return "%s[%d-%d]" % (prefix, first, last)
+
+
+def split(nodes, containers):
+    """Yield (container index, first node, last node), 1-based."""
+    base, extra = divmod(nodes, containers)
+    first = 1
+    for c in range(1, containers + 1):
+        count = base + (1 if c <= extra else 0)
+        if count:
+            yield c, first, first + count - 1
+        first += count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--nodes", type=int, default=2)
+    parser.add_argument("--containers", type=int, default=0,
+                        help="compute containers (default: one per node up to 100)")
+    parser.add_argument("--cpus", type=int, default=1, help="CPUs per emulated node")
+    parser.add_argument("--memory", type=int, default=1000, help="RealMemory per node")
+    parser.add_argument("--image", default="slurm-docker-cluster:${IMAGE_TAG:-19.05.1}")
+    parser.add_argument("--config-server", action="store_true",
+                        help="fetch the configuration with slurm-config")
+    parser.add_argument("--isolation", action="store_true",
+                        help="compute CPUs and I/O weight of the isolation profile")
+    parser.add_argument("--subnet", metavar="CIDR",
+                        help="static addresses in CIDR and an /etc/hosts for all containers")
+    parser.add_argument("--output", default=os.path.join(ROOT, "profiles", "topology"))
+    args = parser.parse_args()
+
+    containers = args.containers or min(args.nodes, 100)
+    if containers > args.nodes:
+        parser.error("more containers than nodes")
+    if containers < 2:
+        # c1 and c2 of the base compose file are always started.
+        parser.error("at least 2 containers")
+    emulated = args.nodes > containers
+    os.makedirs(args.output, exist_ok=True)
+
+    # mysql, slurmdbd and slurmctld at .10-.12 of the subnet, container cN at
+    # 256 + N and the addresses Docker assigns in the last /24.
+    addresses = {}
+    if args.subnet:
+        subnet = ipaddress.ip_network(args.subnet)
+        if subnet.num_addresses < 256 + containers + 1 + 256:
+            parser.error("subnet %s too small for %d containers" % (subnet, containers))
+        dynamic = ipaddress.ip_network("%s/24" % subnet[-256])
+        for i, name in enumerate(BASE_SERVICES):
+            addresses[name] = subnet[10 + i]
+        for c in range(1, containers + 1):
+            addresses["c%d" % c] = subnet[256 + c]
+        # Relative to the project directory, the repository root.
+        hosts_file = "./" + os.path.relpath(os.path.join(args.output, "hosts"), ROOT)
+        network = lambda name: NETWORK.format(address=addresses[name])
+        hosts = HOSTS_VOLUME.format(hosts=hosts_file)
+    else:
+        network = lambda name: ""
+        hosts = ""
+
+    if args.config_server:
+        environment = '\n      SLURM_CONFIG_SERVER: "http://slurmctld:6820"'
+        etc_slurm = "/etc/slurm"
+    else:
+        environment = ""
+        etc_slurm = "etc_slurm:/etc/slurm"
+
+    services = []
+    node_lines = []
+    for c, first, last in split(args.nodes, containers):
+        name = "c%d" % c
+        node_addr = " NodeAddr=%s" % addresses[name] if addresses else ""
+        if emulated:
+            nodenames = hostlist("e", first, last)
+            count = last - first + 1
+            node_lines.append(
+                "NodeName=%s%s NodeHostname=%s Port=[%d-%d] CPUs=%d RealMemory=%d State=UNKNOWN"
+                % (nodenames, node_addr, name, FIRST_PORT, FIRST_PORT + count - 1, args.cpus,
+                   args.memory))
+            ports = "\n      - \"%d-%d\"" % (FIRST_PORT, FIRST_PORT + count - 1)
+        else:
+            nodenames = ""
+            ports = ""
+            if addresses:
+                node_lines.append("NodeName=%s%s NodeHostname=%s RealMemory=%d State=UNKNOWN"
+                                  % (name, node_addr, name, args.memory))
+        services.append(SERVICE.format(name=name, image=args.image, nodenames=nodenames,
+                                       environment=environment, etc_slurm=etc_slurm,
+                                       ports=ports, hosts=hosts, network=network(name),
+                                       isolation=ISOLATION if args.isolation else ""))
+    if addresses:
+        for name in BASE_SERVICES:
+            volumes = "\n    volumes:" + hosts if name != "mysql" else ""
+            services.append(BASE_SERVICE.format(name=name, network=network(name),
+                                                volumes=volumes))
+
+    if emulated:
+        nodes = hostlist("e", 1, args.nodes)
+    else:
+        nodes = hostlist("c", 1, args.nodes)
+        if not addresses:
+            node_lines.append("NodeName=%s RealMemory=%d State=UNKNOWN" % (nodes, args.memory))
+
+    with open(os.path.join(args.output, "docker-compose.yml"), "w") as f:
+        f.write('version: "2.2"\n\n')
+        f.write("# Generated by generate_topology.py: %d nodes in %d containers.\n\n"
+                % (args.nodes, containers))
+        f.write("services:\n")
+        f.write("\n".join(services))
+        if addresses:
+            f.write("\nnetworks:\n  default:\n    ipam:\n      config:\n"
+                    "        - subnet: %s\n          ip_range: %s\n" % (subnet, dynamic))
+            with open(os.path.join(args.output, "hosts"), "w") as hosts_out:
+                hosts_out.write("# Generated by generate_topology.py.\n")
+                hosts_out.write("127.0.0.1\tlocalhost\n::1\tlocalhost ip6-localhost ip6-loopback\n")
+                for name in list(BASE_SERVICES) + ["c%d" % c for c in range(1, containers + 1)]:
+                    hosts_out.write("%s\t%s\n" % (addresses[name], name))
+
+    with open(os.path.join(args.output, "nodes.conf"), "w") as f:
+        f.write("# COMPUTE NODES (generated by generate_topology.py)\n")
+        f.write("\n".join(node_lines) + "\n")
+        f.write("#\n# PARTITIONS\n")
+        f.write("PartitionName=normal Default=yes Nodes=%s Priority=50 DefMemPerCPU=500 "
+                "Shared=NO MaxNodes=1 MaxTime=5-00:00:00 DefaultTime=5-00:00:00 State=UP\n"
+                % nodes)
+
+    with open(os.path.join(args.output, "slurm.conf"), "w") as f:
+        f.write("# Generated by generate_topology.py.\n")
+        if emulated:
+            f.write("# Several slurmd per container need their own files.\n")
+            f.write("SlurmdPidFile=/var/run/slurmd/slurmd-%n.pid\n")
+            f.write("SlurmdSpoolDir=/var/spool/slurmd/%n\n")
+            f.write("SlurmdLogFile=/var/log/slurm/slurmd-%n.log\n")
+        if addresses:
+            f.write("ControlAddr=%s\n" % addresses["slurmctld"])
+        if args.nodes > 64:
+            # Keep node messages fanned out over a tree.
+            f.write("TreeWidth=%d\n" % max(16, int(args.nodes ** 0.5)))
+
+    print("%d nodes (%s) in %d containers%s written to %s" % (
+        args.nodes, "emulated" if emulated else "one slurmd per container", containers,
+        " with static addresses in %s" % args.subnet if addresses else "", args.output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,36 @@
+/*
+ * Preloaded into slurmd by node-supervisor.sh.  A container shares the
+ * host's uptime, so a restarted slurmd would report the host's boot time
+ * and slurmctld would never see a node reboot complete.  This sysinfo()
+ * reports the uptime since the boot time the supervisor recorded instead.
+ *
+ *     gcc -shared -fPIC -O2 -o boot-time.so boot-time.c -ldl
+ */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdio.h>
+#include <sys/sysinfo.h>
+#include <time.h>
+
+#define BOOT_TIME_FILE "/run/slurm-node/boot-time"
+
+int sysinfo(struct sysinfo *info)
+{
+	static int (*real_sysinfo)(struct sysinfo *);
+	FILE *fp;
+	long boot, up;
+	int rc;
+
+	if (!real_sysinfo)
+		real_sysinfo = (int (*)(struct sysinfo *)) dlsym(RTLD_NEXT, "sysinfo");
+	rc = real_sysinfo(info);
+	if (rc != 0 || !(fp = fopen(BOOT_TIME_FILE, "r")))
+		return rc;
+	if (fscanf(fp, "%ld", &boot) == 1) {
+		up = (long) time(NULL) - boot;
+		if (up >= 0 && up < info->uptime)
+			info->uptime = up;
+	}
+	fclose(fp);
+	return rc;
+}
@@ -0,0 +1,59 @@
+#!/bin/bash
+#
+# Job lifecycle timestamp hook.  The image links this script as prolog,
+# epilog, task-prolog and task-epilog; the name it is invoked under selects
+# the events it records.  One line is appended per event to
+# /var/log/slurm/lifecycle/<host>.log:
+#
+#     <epoch seconds> <job id> <event> <host>
+#
+# Site prolog/epilog scripts placed in /etc/slurm/prolog.d and
+# /etc/slurm/epilog.d run between the start and end events so their cost
+# shows up as the prolog/epilog phase.
+#
+# Nothing may be written to stdout: slurmd interprets TaskProlog output.
+
+LIFECYCLE_DIR=/var/log/slurm/lifecycle
+HOST=$(hostname -s)
+
+record() {
+    [ -d "$LIFECYCLE_DIR" ] || mkdir -p -m 1777 "$LIFECYCLE_DIR" 2> /dev/null
+    echo "$(date +%s.%N) ${SLURM_JOB_ID:-${SLURM_JOBID}} $1 ${HOST}" \
+        >> "${LIFECYCLE_DIR}/${HOST}.log" 2> /dev/null
+}
+
+run_dir() {
+    local script
+    for script in "$1"/*
+    do
+        if [ -x "$script" ]
+        then
+            "$script" > /dev/null || return $?
+        fi
+    done
+}
+
+case "$(basename "$0")" in
+    prolog)
+        record prolog_start
+        run_dir /etc/slurm/prolog.d
+        rc=$?
+        record prolog_end
+        exit $rc
+        ;;
+    epilog)
+        record epilog_start
+        run_dir /etc/slurm/epilog.d
+        rc=$?
+        record epilog_end
+        exit $rc
+        ;;
+    task-prolog)
+        record task_start
+        ;;
+    task-epilog)
+        record task_end
+        ;;
+esac
+
+exit 0
@@ -0,0 +1,14 @@
+#!/bin/bash
+#
+# RebootProgram of the compute containers: asks the node supervisor
+# (node-supervisor.sh) to "reboot" this node.  Returns at once; slurmd is
+# stopped and started again by the supervisor.
+
+CONTROL=/run/slurm-node/control
+
+if [ ! -p "$CONTROL" ]
+then
+    echo "node-reboot: no node supervisor on $(hostname -s)" >&2
+    exit 1
+fi
+echo reboot > "$CONTROL"
@@ -0,0 +1,60 @@
+#!/bin/bash
+#
+# Runs slurmd on a compute container and stands in for the node's power
+# control, so that `scontrol reboot` works without restarting the container.
+#
+# The RebootProgram (node-reboot) writes "reboot" to the control FIFO
+# /run/slurm-node/control.  The supervisor then stops slurmd and any job
+# steps, waits NODE_BOOT_SECONDS as a reboot would, records a new boot time
+# and starts slurmd again.  slurmd runs with boot-time.so preloaded, which
+# reports the uptime since that boot time: slurmctld only counts a reboot
+# as done once the node's boot time has moved past the request.
+
+NODE_DIR=/run/slurm-node
+CONTROL="${NODE_DIR}/control"
+NODE_BOOT_SECONDS=${NODE_BOOT_SECONDS:-10}
+
+boot() {
+    date +%s > "${NODE_DIR}/boot-time"
+    LD_PRELOAD=/usr/local/lib64/boot-time.so /usr/sbin/slurmd -Dvvv &
+    SLURMD_PID=$!
+}
+
+shutdown() {
+    kill -TERM "$SLURMD_PID" 2> /dev/null
+    wait "$SLURMD_PID" 2> /dev/null
+    pkill -KILL slurmstepd 2> /dev/null
+}
+
+mkdir -p "$NODE_DIR"
+rm -f "$CONTROL"
+mkfifo -m 600 "$CONTROL"
+# Held open read-write so that writers never block and reads can time out.
+exec 3<> "$CONTROL"
+
+trap 'shutdown; exit 0' TERM INT
+
+boot
+while :
+do
+    if read -r -t 1 -u 3 request
+    then
+        case "$request" in
+            reboot)
+                echo "---> Rebooting: stopping slurmd for ${NODE_BOOT_SECONDS}s ..."
+                shutdown
+                rm -rf /tmp/* 2> /dev/null
+                sleep "$NODE_BOOT_SECONDS"
+                echo "---> Starting the Slurm Node Daemon (slurmd) ..."
+                boot
+                ;;
+            *)
+                echo "-- Ignoring unknown request: ${request}" >&2
+                ;;
+        esac
+    elif ! kill -0 "$SLURMD_PID" 2> /dev/null
+    then
+        echo "-- slurmd exited" >&2
+        exit 1
+    fi
+done
@@ -0,0 +1,144 @@
+#!/bin/bash
+#
+# Hot backups of the accounting database, run in the mysql-backup sidecar.
+#
+#     mysql-backup backup [physical|logical]   take one backup
+#     mysql-backup schedule                    back up every BACKUP_INTERVAL
+#     mysql-backup list                        list backups
+#     mysql-backup restore NAME                restore (mysql must be stopped
+#                                              for physical backups)
+#
+# Physical backups use xtrabackup on the shared var_lib_mysql volume: InnoDB
+# pages are copied while slurmdbd keeps committing and only a brief lock is
+# taken for the non-transactional tables.  --throttle bounds the I/O taken
+# from mysql.  Logical backups are a mysqldump --single-transaction
+# snapshot, rate limited with pv.  Both run at idle I/O priority.  A failed
+# backup is removed and never replaces a complete one; the schedule retries
+# it after BACKUP_RETRY seconds.
+set -e -o pipefail
+
+BACKUP_DIR=${BACKUP_DIR:-/backup}
+DATADIR=${DATADIR:-/var/lib/mysql}
+BACKUP_HOST=${BACKUP_HOST:-mysql}
+BACKUP_USER=${BACKUP_USER:-backup}
+BACKUP_PASSWORD=${BACKUP_PASSWORD:-backup}
+BACKUP_MODE=${BACKUP_MODE:-physical}
+BACKUP_INTERVAL=${BACKUP_INTERVAL:-86400}
+BACKUP_RETRY=${BACKUP_RETRY:-300}
+BACKUP_KEEP=${BACKUP_KEEP:-7}
+BACKUP_THROTTLE=${BACKUP_THROTTLE:-0}
+BACKUP_RATE=${BACKUP_RATE:-0}
+DATABASE=${DATABASE:-slurm_acct_db}
+
+LOW_PRIORITY="nice -n 19 ionice -c 3"
+
+backup_physical() {
+    local target=$1 throttle=()
+    if [ "$BACKUP_THROTTLE" != "0" ]
+    then
+        throttle=(--throttle="$BACKUP_THROTTLE")
+    fi
+    $LOW_PRIORITY xtrabackup --backup --datadir="$DATADIR" --target-dir="$target" \
+        --host="$BACKUP_HOST" --user="$BACKUP_USER" --password="$BACKUP_PASSWORD" \
+        "${throttle[@]}" 2> "${target}.log" || return 1
+    # Prepare right away so that a restore is only a copy.
+    xtrabackup --prepare --target-dir="$target" 2>> "${target}.log"
+}
+
+backup_logical() {
+    local target=$1 limit=(cat)
+    if [ "$BACKUP_RATE" != "0" ]
+    then
+        limit=(pv -q -L "$BACKUP_RATE")
+    fi
+    mkdir -p "$target" || return 1
+    $LOW_PRIORITY mysqldump -h "$BACKUP_HOST" -u"$BACKUP_USER" -p"$BACKUP_PASSWORD" \
+            --single-transaction --quick --routines --databases "$DATABASE" 2> "${target}.log" \
+        | "${limit[@]}" \
+        | $LOW_PRIORITY gzip -1 > "${target}/${DATABASE}.sql.gz" || return 1
+    # A dump that was cut short lacks mysqldump's trailer.
+    gunzip -c "${target}/${DATABASE}.sql.gz" | tail -n 1 | grep -q "^-- Dump completed" || {
+        echo "dump of ${DATABASE} is incomplete" >> "${target}.log"
+        return 1
+    }
+}
+
+backup() {
+    local mode=${1:-$BACKUP_MODE}
+    local name="$(date -u +%Y%m%dT%H%M%SZ)-${mode}"
+    local start=$(date +%s)
+    echo "---> Starting ${mode} backup ${name} ..."
+    case "$mode" in
+        physical|logical) ;;
+        *) echo "unknown backup mode: ${mode}" >&2; exit 2 ;;
+    esac
+    # Errors are checked explicitly: set -e does not apply in `backup || ...`.
+    if ! "backup_${mode}" "${BACKUP_DIR}/.${name}"
+    then
+        rm -rf "${BACKUP_DIR}/.${name}"
+        mv "${BACKUP_DIR}/.${name}.log" "${BACKUP_DIR}/${name}.failed.log" 2> /dev/null
+        echo "-- Backup ${name} failed, see ${BACKUP_DIR}/${name}.failed.log" >&2
+        return 1
+    fi
+    # Only complete backups get a visible name.
+    mv "${BACKUP_DIR}/.${name}" "${BACKUP_DIR}/${name}" || return 1
+    mv "${BACKUP_DIR}/.${name}.log" "${BACKUP_DIR}/${name}.log" || return 1
+    echo "-- Backup ${name} done in $(( $(date +%s) - start ))s, $(du -sh "${BACKUP_DIR}/${name}" | cut -f1)"
+    prune
+}
+
+prune() {
+    ls -1d "${BACKUP_DIR}"/*-physical "${BACKUP_DIR}"/*-logical 2> /dev/null \
+        | sort | head -n -"$BACKUP_KEEP" \
+        | while read -r old
+          do
+              echo "-- Removing old backup $(basename "$old") ..."
+              rm -rf "$old" "${old}.log"
+          done
+}
+
+restore() {
+    local source="${BACKUP_DIR}/$1"
+    [ -d "$source" ] || { echo "no such backup: $1" >&2; exit 1; }
+    echo "---> Restoring $1 ..."
+    case "$source" in
+        *-physical)
+            if mysqladmin -h "$BACKUP_HOST" ping > /dev/null 2>&1
+            then
+                echo "mysql is running; stop it before a physical restore" >&2
+                exit 1
+            fi
+            find "$DATADIR" -mindepth 1 -delete
+            # The backup was prepared when it was taken; copying it back is
+            # all a restore takes.
+            xtrabackup --copy-back --target-dir="$source" --datadir="$DATADIR" --parallel=4
+            chown -R 999:999 "$DATADIR"
+            ;;
+        *-logical)
+            gunzip -c "${source}/${DATABASE}.sql.gz" \
+                | mysql -h "$BACKUP_HOST" -u"$BACKUP_USER" -p"$BACKUP_PASSWORD"
+            ;;
+    esac
+    echo "-- Restore of $1 done"
+}
+
+case "$1" in
+    backup) backup "$2" ;;
+    schedule)
+        # A failed backup, e.g. before setup.sh has created the backup user,
+        # must not end the schedule.
+        while :
+        do
+            if backup
+            then
+                sleep "$BACKUP_INTERVAL"
+            else
+                echo "-- Retrying in ${BACKUP_RETRY}s" >&2
+                sleep "$BACKUP_RETRY"
+            fi
+        done
+        ;;
+    list) ls -1 "$BACKUP_DIR" | grep -v '\.log$' ;;
+    restore) restore "$2" ;;
+    *) exec "$@" ;;
+esac
@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# Restore a backup taken by the mysql-backup sidecar.  slurmdbd is stopped
+# for the restore; slurmctld queues accounting records meanwhile and sends
+# them once slurmdbd is back.
+#
+#     PROFILES=backup ./profiles/backup/restore.sh NAME
+set -e
+
+. "$(dirname "$0")/../../benchmarks/lib.sh"
+
+[ -n "$1" ] || { compose --profile backup run --rm mysql-backup list; exit 2; }
+
+log "Stopping slurmdbd ..."
+compose --profile backup stop slurmdbd
+
+case "$1" in
+    *-physical)
+        log "Stopping mysql ..."
+        compose --profile backup stop mysql
+        compose --profile backup run --rm --no-deps mysql-backup restore "$1"
+        compose --profile backup start mysql
+        ;;
+    *)
+        compose --profile backup run --rm mysql-backup restore "$1"
+        ;;
+esac
+
+log "Starting slurmdbd ..."
+compose --profile backup start slurmdbd
@@ -0,0 +1,20 @@
+#!/bin/bash
+#
+# Create the database user of the mysql-backup sidecar.
+#
+#     PROFILES=backup ./profiles/backup/setup.sh
+set -e
+
+. "$(dirname "$0")/../../benchmarks/lib.sh"
+
+BACKUP_PASSWORD=${BACKUP_PASSWORD:-backup}
+
+ROOT=$(mysql_root_password mysql)
+[ -n "$ROOT" ] || die "root password not found in the mysql container logs"
+
+log "Creating the backup user ..."
+docker exec -i mysql mysql -uroot -p"$ROOT" 2> /dev/null <<SQL
+CREATE USER IF NOT EXISTS 'backup'@'%' IDENTIFIED BY '${BACKUP_PASSWORD}';
+GRANT SELECT, RELOAD, LOCK TABLES, PROCESS, REPLICATION CLIENT, SHOW VIEW, EVENT, TRIGGER ON *.* TO 'backup'@'%';
+GRANT ALL PRIVILEGES ON slurm_acct_db.* TO 'backup'@'%';
+SQL
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+"""Incremental Parquet export of slurm_acct_db.
+
+Reads the job, step and association usage tables of one cluster directly
+from MySQL and writes Hive-style partitioned Parquet files:
+
+    /export/job/day=YYYY-MM-DD/part-<batch>.parquet      by job end day
+    /export/step/day=YYYY-MM-DD/part-<batch>.parquet     by job end day
+    /export/assoc_usage_hour/day=YYYY-MM-DD/part-<batch>.parquet
+
+Only finished jobs are exported.  /export/_checkpoint.json records how far
+each table has been exported and is replaced atomically after the files of a
+batch are written, so a re-run only reads new rows.  File names derive from
+the checkpoint a batch started from, so a batch repeated after a crash
+overwrites its own files instead of duplicating them.  A job modified after
+it was exported is exported again; readers keep the row with the latest
+mod_time per job_db_inx.
+
+Every file of a dataset has the same schema, mapped from the MySQL column
+types of its table, so that a column that is all NULL in one partition does
+not change its type there.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+import time
+from collections import defaultdict
+
+import pyarrow as pa
+import pyarrow.parquet as pq
+import pymysql
+import pymysql.cursors
+
+DATASETS = ("job", "step", "assoc_usage_hour")
+
+# Parquet types of the MySQL column types in slurm_acct_db: (signed, unsigned).
+TYPES = {
+    "tinyint": (pa.int8(), pa.uint8()),
+    "smallint": (pa.int16(), pa.uint16()),
+    "mediumint": (pa.int32(), pa.uint32()),
+    "int": (pa.int32(), pa.uint32()),
+    "bigint": (pa.int64(), pa.uint64()),
+    "float": (pa.float32(), pa.float32()),
+    "double": (pa.float64(), pa.float64()),
+    "char": (pa.string(), pa.string()),
+    "varchar": (pa.string(), pa.string()),
+    "tinytext": (pa.string(), pa.string()),
+    "text": (pa.string(), pa.string()),
+    "mediumtext": (pa.string(), pa.string()),
+    "longtext": (pa.string(), pa.string()),
+    "tinyblob": (pa.binary(), pa.binary()),
+    "blob": (pa.binary(), pa.binary()),
+    "mediumblob": (pa.binary(), pa.binary()),
+    "longblob": (pa.binary(), pa.binary()),
+}
+
+
+def env(name, default):
+    return os.environ.get("EXPORT_" + name, default)
+
+
+def day(epoch):
+    return time.strftime("%Y-%m-%d", time.gmtime(int(epoch)))
+
+
+class Exporter(object):
+    def __init__(self, args):
+        self.args = args
+        self.root = args.output
+        self.cluster = args.cluster
+        self.checkpoint_path = os.path.join(self.root, "_checkpoint.json")
+        self.conn = pymysql.connect(
+            host=args.host, user=args.user, password=args.password,
+            database=args.database, cursorclass=pymysql.cursors.SSDictCursor)
+        self.checkpoint = {}
+        if os.path.exists(self.checkpoint_path):
+            with open(self.checkpoint_path) as f:
+                self.checkpoint = json.load(f)
+        self.stats = defaultdict(int)
+        self.schemas = {}
+
+    def table(self, name):
+        return "`%s_%s`" % (self.cluster, name)
+
+    def schema(self, name):
+        """The Parquet schema of table name, in column order."""
+        fields = []
+        for column in self.query(
+                "SELECT COLUMN_NAME AS name, DATA_TYPE AS type, COLUMN_TYPE AS full_type"
+                " FROM INFORMATION_SCHEMA.COLUMNS WHERE TABLE_SCHEMA = %s AND TABLE_NAME = %s"
+                " ORDER BY ORDINAL_POSITION",
+                (self.args.database, "%s_%s" % (self.cluster, name))):
+            if column["type"] not in TYPES:
+                raise SystemExit("slurm-export: %s.%s: unsupported type %s"
+                                 % (name, column["name"], column["full_type"]))
+            types = TYPES[column["type"]]
+            fields.append(pa.field(column["name"], types["unsigned" in column["full_type"]]))
+        if not fields:
+            raise SystemExit("slurm-export: no table %s_%s in %s"
+                             % (self.cluster, name, self.args.database))
+        return pa.schema(fields)
+
+    def save_checkpoint(self):
+        tmp = self.checkpoint_path + ".tmp"
+        with open(tmp, "w") as f:
+            json.dump(self.checkpoint, f, indent=2, sort_keys=True)
+            f.flush()
+            os.fsync(f.fileno())
+        os.rename(tmp, self.checkpoint_path)
+
+    def write(self, dataset, batch, rows, day_of):
+        """Write rows partitioned by day; return the number of files."""
+        by_day = defaultdict(list)
+        for row in rows:
+            by_day[day_of(row)].append(row)
+        for partition, part_rows in by_day.items():
+            directory = os.path.join(self.root, dataset, "day=" + partition)
+            os.makedirs(directory, exist_ok=True)
+            schema = self.schemas[dataset]
+            columns = {key: [r[key] for r in part_rows] for key in schema.names}
+            table = pa.Table.from_pydict(columns, schema=schema)
+            path = os.path.join(directory, "part-%s.parquet" % batch)
+            pq.write_table(table, path + ".tmp", compression=self.args.compression)
+            os.rename(path + ".tmp", path)
+            self.stats[dataset + "_bytes"] += os.path.getsize(path)
+        self.stats[dataset + "_rows"] += len(rows)
+        return len(by_day)
+
+    def query(self, sql, params=()):
+        with self.conn.cursor() as cursor:
+            cursor.execute(sql, params)
+            for row in cursor:
+                yield row
+
+    def export_jobs(self):
+        mark = self.checkpoint.get("job", {"mod_time": 0, "job_db_inx": 0})
+        while True:
+            jobs = list(self.query(
+                "SELECT * FROM " + self.table("job_table") +
+                " WHERE time_end > 0 AND (mod_time > %s OR (mod_time = %s AND job_db_inx > %s))"
+                " ORDER BY mod_time, job_db_inx LIMIT %s",
+                (mark["mod_time"], mark["mod_time"], mark["job_db_inx"], self.args.batch)))
+            if not jobs:
+                break
+            batch = "%d-%d" % (mark["mod_time"], mark["job_db_inx"])
+            end_day = {}
+            for job in jobs:
+                end_day[job["job_db_inx"]] = day(job["time_end"])
+            self.write("job", batch, jobs, lambda r: end_day[r["job_db_inx"]])
+
+            steps = list(self.query(
+                "SELECT * FROM " + self.table("step_table") +
+                " WHERE job_db_inx IN (" + ",".join(str(i) for i in end_day) + ")"))
+            if steps:
+                self.write("step", batch, steps, lambda r: end_day[r["job_db_inx"]])
+
+            last = jobs[-1]
+            mark = {"mod_time": last["mod_time"], "job_db_inx": last["job_db_inx"]}
+            self.checkpoint["job"] = mark
+            self.save_checkpoint()
+            self.progress()
+            if len(jobs) < self.args.batch:
+                break
+
+    def export_usage(self):
+        # Rolled-up hours are final; export each hour once, a window of
+        # whole days at a time.
+        mark = self.checkpoint.get("assoc_usage_hour", {"time_start": 0})
+        bounds = list(self.query(
+            "SELECT MIN(time_start) AS first, MAX(time_start) AS latest FROM " +
+            self.table("assoc_usage_hour_table")))[0]
+        if bounds["latest"] is None:
+            return
+        mark["time_start"] = max(mark["time_start"], bounds["first"] - 1)
+        window = self.args.usage_days * 86400
+        while mark["time_start"] < bounds["latest"]:
+            upper = min(bounds["latest"], mark["time_start"] + window)
+            rows = list(self.query(
+                "SELECT * FROM " + self.table("assoc_usage_hour_table") +
+                " WHERE time_start > %s AND time_start <= %s",
+                (mark["time_start"], upper)))
+            if rows:
+                self.write("assoc_usage_hour", str(mark["time_start"]), rows,
+                           lambda r: day(r["time_start"]))
+            mark = {"time_start": upper}
+            self.checkpoint["assoc_usage_hour"] = mark
+            self.save_checkpoint()
+            self.progress()
+
+    def progress(self):
+        if self.args.verbose:
+            sys.stderr.write("-- %s\n" % json.dumps(dict(self.stats), sort_keys=True))
+
+    def run(self):
+        start = time.time()
+        os.makedirs(self.root, exist_ok=True)
+        for dataset in DATASETS:
+            self.schemas[dataset] = self.schema(dataset + "_table")
+        self.export_jobs()
+        self.export_usage()
+        elapsed = time.time() - start
+        result = dict(self.stats)
+        result["elapsed_s"] = round(elapsed, 3)
+        result["job_rows_per_s"] = round(result.get("job_rows", 0) / elapsed, 1) if elapsed else 0
+        print(json.dumps(result, sort_keys=True))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--output", default=env("OUTPUT", "/export"))
+    parser.add_argument("--cluster", default=env("CLUSTER", "linux"))
+    parser.add_argument("--host", default=env("DB_HOST", "mysql"))
+    parser.add_argument("--user", default=env("DB_USER", "slurm"))
+    parser.add_argument("--password", default=env("DB_PASSWORD", "password"))
+    parser.add_argument("--database", default=env("DB_NAME", "slurm_acct_db"))
+    parser.add_argument("--batch", type=int, default=int(env("BATCH", "100000")))
+    parser.add_argument("--usage-days", type=int, default=7,
+                        help="days of usage rows read per batch")
+    parser.add_argument("--compression", default="zstd")
+    parser.add_argument("--reset", action="store_true",
+                        help="remove exported files and the checkpoint")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    if args.reset:
+        for dataset in DATASETS:
+            shutil.rmtree(os.path.join(args.output, dataset), ignore_errors=True)
+        if os.path.exists(os.path.join(args.output, "_checkpoint.json")):
+            os.unlink(os.path.join(args.output, "_checkpoint.json"))
+    Exporter(args).run()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,22 @@
+# Settings of slurm-gateway.
+#
+# compose in benchmarks/lib.sh reads this file whenever the gateway profile
+# is used; when running docker-compose by hand, export it first:
+#
+#     set -a; . profiles/gateway/env.sh; set +a
+#
+# Values already in the environment take precedence.
+
+# Shared token clients send as "Authorization: Bearer TOKEN".  Generated
+# once into profiles/gateway/token, which is not committed.
+if [ -z "$GATEWAY_TOKEN" ]
+then
+    gateway_token_file="$(dirname "${BASH_SOURCE[0]}")/token"
+    [ -s "$gateway_token_file" ] ||
+        (umask 077; od -An -N16 -tx1 /dev/urandom | tr -d ' \n' > "$gateway_token_file")
+    GATEWAY_TOKEN=$(cat "$gateway_token_file")
+    unset gateway_token_file
+fi
+
+# Unprivileged user (in the image) that submits the jobs of all clients.
+GATEWAY_USER=${GATEWAY_USER:-portal}
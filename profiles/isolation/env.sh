@@ -0,0 +1,38 @@
+# CPU and I/O isolation of the control plane: the one place to set it.
+#
+# compose in benchmarks/lib.sh reads this file whenever the isolation profile
+# is used; when running docker-compose by hand, export it first:
+#
+#     set -a; . profiles/isolation/env.sh; set +a
+#
+# Values already in the environment take precedence.
+
+# CPUs reserved for mysql, slurmdbd and slurmctld (default: CPUs 0-1, or
+# only CPU 0 on hosts with fewer than 4) and the CPUs of the compute
+# containers (default: all the others).  Use disjoint sets.
+isolation_cpus=$(nproc)
+if [ "$isolation_cpus" -lt 2 ] && [ -z "$CONTROL_CPUS$COMPUTE_CPUS" ]
+then
+    echo "isolation profile: needs at least 2 CPUs, this host has ${isolation_cpus}" >&2
+    unset isolation_cpus
+    return 1
+fi
+isolation_reserved=$(( isolation_cpus >= 4 ? 2 : 1 ))
+if [ "$isolation_reserved" = 1 ]
+then
+    CONTROL_CPUS=${CONTROL_CPUS:-0}
+else
+    CONTROL_CPUS=${CONTROL_CPUS:-0-1}
+fi
+if [ "$isolation_reserved" = $(( isolation_cpus - 1 )) ]
+then
+    COMPUTE_CPUS=${COMPUTE_CPUS:-${isolation_reserved}}
+else
+    COMPUTE_CPUS=${COMPUTE_CPUS:-${isolation_reserved}-$(( isolation_cpus - 1 ))}
+fi
+unset isolation_cpus isolation_reserved
+
+# blkio weights (10-1000; Docker's default is 500).  They take effect with
+# the CFQ or BFQ I/O scheduler on the devices of the Docker data root.
+CONTROL_IO_WEIGHT=${CONTROL_IO_WEIGHT:-1000}
+COMPUTE_IO_WEIGHT=${COMPUTE_IO_WEIGHT:-100}
@@ -0,0 +1,25 @@
+#!/bin/bash
+#
+# Enable the local licenses of the licenses profile and register a remote
+# license (ansys@flexlm) with slurmdbd for the cluster.
+#
+#     ./profiles/licenses/setup.sh [REMOTE_COUNT]
+set -e
+
+. "$(dirname "$0")/../../benchmarks/lib.sh"
+
+REMOTE_COUNT=${1:-8}
+
+log "Registering ${REMOTE_COUNT} remote ansys@flexlm licenses ..."
+if ctld sacctmgr -n -P show resource name=ansys format=name | grep -q ansys
+then
+    ctld sacctmgr -i modify resource name=ansys server=flexlm set count="$REMOTE_COUNT" > /dev/null
+else
+    ctld sacctmgr -i add resource name=ansys server=flexlm servertype=flexlm \
+        count="$REMOTE_COUNT" type=license cluster="$CLUSTER" percentallowed=100 > /dev/null
+fi
+
+log "Enabling the local licenses ..."
+slurm_conf_apply licenses
+slurm_restart
+ctld scontrol show licenses
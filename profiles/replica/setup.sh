@@ -0,0 +1,61 @@
+#!/bin/bash
+#
+# Start replication from mysql to mysql-replica.  Safe to rerun: the replica
+# is reloaded from a consistent dump of the primary each time.
+#
+#     PROFILES=replica ./profiles/replica/setup.sh
+set -e -o pipefail
+
+. "$(dirname "$0")/../../benchmarks/lib.sh"
+
+REPL_PASSWORD=${REPL_PASSWORD:-replication}
+
+PRIMARY_ROOT=$(mysql_root_password mysql)
+REPLICA_ROOT=$(mysql_root_password mysql-replica)
+[ -n "$PRIMARY_ROOT" ] && [ -n "$REPLICA_ROOT" ] || die "root passwords not found in the mysql container logs"
+
+log "Waiting for both databases ..."
+until docker exec mysql mysqladmin -uroot -p"$PRIMARY_ROOT" ping > /dev/null 2>&1 \
+    && docker exec mysql-replica mysqladmin -uroot -p"$REPLICA_ROOT" ping > /dev/null 2>&1
+do
+    sleep 2
+done
+
+log "Creating the replication user on the primary ..."
+docker exec -i mysql mysql -uroot -p"$PRIMARY_ROOT" 2> /dev/null <<SQL
+CREATE USER IF NOT EXISTS 'repl'@'%' IDENTIFIED BY '${REPL_PASSWORD}';
+GRANT REPLICATION SLAVE, REPLICATION CLIENT ON *.* TO 'repl'@'%';
+SQL
+
+log "Loading a consistent snapshot into the replica ..."
+# The connection is set first: a CHANGE MASTER with MASTER_HOST resets the
+# binlog coordinates, so the dump's own CHANGE MASTER TO MASTER_LOG_FILE,
+# MASTER_LOG_POS (--master-data=1) has to come last.
+docker exec -i mysql-replica mysql -uroot -p"$REPLICA_ROOT" 2> /dev/null <<SQL
+STOP SLAVE;
+RESET SLAVE ALL;
+CHANGE MASTER TO MASTER_HOST='mysql', MASTER_USER='repl', MASTER_PASSWORD='${REPL_PASSWORD}';
+SQL
+docker exec mysql mysqldump -uroot -p"$PRIMARY_ROOT" --single-transaction \
+        --master-data=1 --databases slurm_acct_db 2> /dev/null \
+    | docker exec -i mysql-replica mysql -uroot -p"$REPLICA_ROOT" 2> /dev/null \
+    || die "loading the snapshot into the replica failed"
+
+log "Starting replication ..."
+docker exec mysql-replica mysql -uroot -p"$REPLICA_ROOT" -e "START SLAVE;" 2> /dev/null
+
+slave_status() {
+    docker exec mysql-replica mysql -uroot -p"$REPLICA_ROOT" -e "SHOW SLAVE STATUS\G" 2> /dev/null
+}
+for i in $(seq 30)
+do
+    status=$(slave_status)
+    if echo "$status" | grep -q "Slave_IO_Running: Yes" && echo "$status" | grep -q "Slave_SQL_Running: Yes"
+    then
+        break
+    fi
+    sleep 1
+done
+echo "$status" | grep -E "Slave_(IO|SQL)_Running:|Seconds_Behind_Master|Last_(IO|SQL)_Error:"
+echo "$status" | grep -q "Slave_IO_Running: Yes" && echo "$status" | grep -q "Slave_SQL_Running: Yes" \
+    || die "replication is not running on mysql-replica"